@@ -23,6 +23,11 @@ public class ImGui : ModuleRules
 		// Enable runtime loader, if you want this module to be automatically loaded in runtime builds (monolithic).
 		bool bEnableRuntimeLoader = true;
 
+		// Enable thread-local ImGui context, if you want the current context to be set per thread. This allows to update
+		// different contexts in parallel, but debug delegates are still called on the game thread. It also allows to
+		// rebuild the font atlas in the background, after the DPI scale changes.
+		bool bEnableThreadLocalContext = false;
+
 		PCHUsage = PCHUsageMode.UseExplicitOrSharedPCHs;
 
 #if UE_4_24_OR_LATER
@@ -64,6 +69,8 @@ public class ImGui : ModuleRules
 				"CoreUObject",
 				"Engine",
 				"InputCore",
+				"RenderCore",
+				"RHI",
 				"Slate",
 				"SlateCore"
 				// ... add private dependencies that you statically link with here ...	
@@ -97,5 +104,6 @@ public class ImGui : ModuleRules
 #endif
 
 		PrivateDefinitions.Add(string.Format("RUNTIME_LOADER_ENABLED={0}", bEnableRuntimeLoader ? 1 : 0));
+		PrivateDefinitions.Add(string.Format("IMGUI_THREAD_LOCAL_CONTEXT={0}", bEnableThreadLocalContext ? 1 : 0));
 	}
 }
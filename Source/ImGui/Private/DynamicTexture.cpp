@@ -0,0 +1,124 @@
+// Distributed under the MIT License (MIT) (see accompanying LICENSE file)
+
+#include "DynamicTexture.h"
+
+#include <Engine/Texture2D.h>
+#include <RenderingThread.h>
+#include <RHI.h>
+
+
+namespace
+{
+	FORCEINLINE bool IsEmptyRect(const FIntRect& Rect)
+	{
+		return Rect.Width() <= 0 || Rect.Height() <= 0;
+	}
+}
+
+FDynamicTexture::FDynamicTexture(UTexture2D* InTexture, int32 InWidth, int32 InHeight, EPixelFormat InFormat)
+	: Texture(InTexture)
+	, Width(InWidth)
+	, Height(InHeight)
+	, BytesPerPixel(GPixelFormats[InFormat].BlockBytes)
+{
+	checkf(GPixelFormats[InFormat].BlockSizeX == 1 && GPixelFormats[InFormat].BlockSizeY == 1,
+		TEXT("Dynamic textures need an uncompressed pixel format."));
+
+	// Texture is created with zeroed memory, so staging buffers start with the same content.
+	const int32 SizeInBytes = Width * Height * BytesPerPixel;
+	Staging[0].SetNumZeroed(SizeInBytes);
+	Staging[1].SetNumZeroed(SizeInBytes);
+}
+
+FDynamicTexture::~FDynamicTexture()
+{
+	Fences[0].Wait();
+	Fences[1].Wait();
+}
+
+void FDynamicTexture::Update(const FIntRect& Rect, const uint8* Data, int32 SrcPitch)
+{
+	checkf(Data, TEXT("Null data."));
+
+	FIntRect ClippedRect = Rect;
+	ClippedRect.Clip(FIntRect{ 0, 0, Width, Height });
+	if (IsEmptyRect(ClippedRect))
+	{
+		return;
+	}
+
+	// First update in a frame needs to make sure that the buffer is not read and it is up to date.
+	if (IsEmptyRect(DirtyRect))
+	{
+		BeginWrite();
+		DirtyRect = ClippedRect;
+	}
+	else
+	{
+		DirtyRect.Union(ClippedRect);
+	}
+
+	const int32 Pitch = Width * BytesPerPixel;
+	const int32 RowSize = ClippedRect.Width() * BytesPerPixel;
+	const uint8* Src = Data + (ClippedRect.Min.Y - Rect.Min.Y) * SrcPitch + (ClippedRect.Min.X - Rect.Min.X) * BytesPerPixel;
+	uint8* Dst = Staging[WriteBuffer].GetData() + ClippedRect.Min.Y * Pitch + ClippedRect.Min.X * BytesPerPixel;
+	for (int32 Row = 0; Row < ClippedRect.Height(); Row++)
+	{
+		FMemory::Memcpy(Dst + Row * Pitch, Src + Row * SrcPitch, RowSize);
+	}
+}
+
+void FDynamicTexture::Flush()
+{
+	if (IsEmptyRect(DirtyRect))
+	{
+		return;
+	}
+
+	if (Texture.IsValid() && Texture->Resource)
+	{
+		const uint32 Pitch = Width * BytesPerPixel;
+		const uint8* Data = Staging[WriteBuffer].GetData() + DirtyRect.Min.Y * Pitch + DirtyRect.Min.X * BytesPerPixel;
+		const FUpdateTextureRegion2D Region(DirtyRect.Min.X, DirtyRect.Min.Y, DirtyRect.Min.X, DirtyRect.Min.Y,
+			DirtyRect.Width(), DirtyRect.Height());
+
+		// Data stay in the staging buffer until the fence completes, so they don't need to be copied.
+		FTextureResource* Resource = Texture->Resource;
+		ENQUEUE_RENDER_COMMAND(ImGuiUpdateDynamicTexture)([Resource, Region, Pitch, Data](FRHICommandListImmediate& RHICmdList)
+		{
+			if (FRHITexture2D* TextureRHI = Resource->TextureRHI ? Resource->TextureRHI->GetTexture2D() : nullptr)
+			{
+				RHIUpdateTexture2D(TextureRHI, 0, Region, Pitch, Data);
+			}
+		});
+
+		Fences[WriteBuffer].BeginFence();
+	}
+
+	// The other buffer doesn't have data written in this frame.
+	StaleRect = DirtyRect;
+	DirtyRect = FIntRect{};
+	WriteBuffer ^= 1;
+}
+
+void FDynamicTexture::BeginWrite()
+{
+	// Normally, the render thread finishes reading before the game thread starts the next frame.
+	Fences[WriteBuffer].Wait();
+
+	// Bring this buffer up to date with the other one. Both threads only read from the other buffer.
+	if (!IsEmptyRect(StaleRect))
+	{
+		const int32 Pitch = Width * BytesPerPixel;
+		const int32 Offset = StaleRect.Min.Y * Pitch + StaleRect.Min.X * BytesPerPixel;
+		const int32 RowSize = StaleRect.Width() * BytesPerPixel;
+		const uint8* Src = Staging[WriteBuffer ^ 1].GetData() + Offset;
+		uint8* Dst = Staging[WriteBuffer].GetData() + Offset;
+		for (int32 Row = 0; Row < StaleRect.Height(); Row++)
+		{
+			FMemory::Memcpy(Dst + Row * Pitch, Src + Row * Pitch, RowSize);
+		}
+
+		StaleRect = FIntRect{};
+	}
+}
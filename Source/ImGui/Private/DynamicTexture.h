@@ -0,0 +1,65 @@
+// Distributed under the MIT License (MIT) (see accompanying LICENSE file)
+
+#pragma once
+
+#include <Containers/Array.h>
+#include <Math/IntRect.h>
+#include <PixelFormat.h>
+#include <RenderCommandFence.h>
+#include <UObject/WeakObjectPtr.h>
+
+
+class UTexture2D;
+
+// CPU-side staging for a texture which content is updated from CPU buffers. Updates are copied to one of two staging
+// buffers and coalesced into a single dirty rectangle, which is uploaded once per frame. While the render thread reads
+// from one buffer, updates are written to the other one, so uploads don't need to copy or allocate memory.
+class FDynamicTexture
+{
+public:
+
+	// Create staging for a texture. Texture should be created with the same size and an uncompressed format.
+	FDynamicTexture(UTexture2D* InTexture, int32 InWidth, int32 InHeight, EPixelFormat InFormat);
+
+	// Waits until the render thread finishes reading from staging buffers.
+	~FDynamicTexture();
+
+	FDynamicTexture(const FDynamicTexture&) = delete;
+	FDynamicTexture& operator=(const FDynamicTexture&) = delete;
+
+	FDynamicTexture(FDynamicTexture&&) = delete;
+	FDynamicTexture& operator=(FDynamicTexture&&) = delete;
+
+	// Copy data to a rectangle of the staging buffer and add it to the dirty rectangle.
+	// @param Rect - Rectangle to update (clamped to the texture size)
+	// @param Data - Source data, starting from the first texel of the rectangle
+	// @param SrcPitch - Number of bytes between rows of source data
+	void Update(const FIntRect& Rect, const uint8* Data, int32 SrcPitch);
+
+	// Upload the dirty rectangle to the texture and switch staging buffers. Does nothing, if there were no updates.
+	void Flush();
+
+	// Get the number of bytes used by staging buffers.
+	SIZE_T GetAllocatedSize() const { return Staging[0].GetAllocatedSize() + Staging[1].GetAllocatedSize(); }
+
+private:
+
+	// Prepare the current staging buffer for writing.
+	void BeginWrite();
+
+	TWeakObjectPtr<UTexture2D> Texture;
+
+	int32 Width = 0;
+	int32 Height = 0;
+	int32 BytesPerPixel = 0;
+
+	TArray<uint8> Staging[2];
+	FRenderCommandFence Fences[2];
+	int32 WriteBuffer = 0;
+
+	// Union of rectangles updated in the current frame.
+	FIntRect DirtyRect;
+
+	// Rectangle uploaded from the other buffer, which needs to be copied to the current buffer before it is written.
+	FIntRect StaleRect;
+};
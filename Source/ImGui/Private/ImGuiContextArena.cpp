@@ -0,0 +1,365 @@
+// Distributed under the MIT License (MIT) (see accompanying LICENSE file)
+
+#include "ImGuiContextArena.h"
+
+#include "ImGuiModuleDebug.h"
+
+#include <Containers/Map.h>
+#include <HAL/PlatformAtomics.h>
+#include <HAL/ThreadSafeCounter.h>
+#include <Misc/ScopeLock.h>
+
+#include <imgui.h>
+
+
+// Header stored before every allocation. Size of the header is a multiple of the default alignment, so memory
+// returned to ImGui has the same alignment as the memory returned by the engine allocator.
+struct FImGuiContextArena::FAllocationHeader
+{
+	union
+	{
+		// Arena that owns this allocation or null, if it was made directly by the engine allocator.
+		FImGuiContextArena* Arena;
+
+		// Next block in the list of blocks released in other threads (owning arena is known from the list).
+		FAllocationHeader* NextRemote;
+	};
+
+	// Size requested by ImGui.
+	uint32 Size;
+
+	// Size class of the block or INDEX_NONE for allocations made by the engine allocator.
+	int32 SizeClass;
+};
+
+// Free block in a size class list.
+struct FImGuiContextArena::FFreeBlock
+{
+	FFreeBlock* Next;
+};
+
+namespace
+{
+	constexpr SIZE_T HeaderSize = 16;
+	constexpr SIZE_T MinBlockSize = 32;
+	constexpr SIZE_T PageSize = 64 * 1024;
+
+	// Limit for bytes in released large blocks that are kept for reuse.
+	constexpr SIZE_T MaxRetainedBytes = 16 * 1024 * 1024;
+
+	// Get the size class that can fit a block of a given size or a value equal or larger than the number of classes,
+	// if block is larger than the largest size class.
+	FORCEINLINE int32 GetSizeClass(SIZE_T BlockSize)
+	{
+		int32 SizeClass = 0;
+		for (SIZE_T ClassSize = MinBlockSize; ClassSize < BlockSize; ClassSize <<= 1)
+		{
+			SizeClass++;
+		}
+		return SizeClass;
+	}
+
+	FORCEINLINE SIZE_T GetBlockSize(int32 SizeClass)
+	{
+		return MinBlockSize << SizeClass;
+	}
+
+	// Arenas bound to contexts. Lookups are cached per thread and the version number allows to detect changes.
+	TMap<ImGuiContext*, FImGuiContextArena*> ContextArenas;
+	FCriticalSection ContextArenasLock;
+	FThreadSafeCounter ContextArenasVersion;
+
+	// Arena set by a scope in this thread. Neutral scope uses no arena.
+	thread_local FImGuiContextArena* ScopeArena = nullptr;
+	thread_local bool bNeutralScope = false;
+	thread_local ImGuiContext* CachedContext = nullptr;
+	thread_local FImGuiContextArena* CachedArena = nullptr;
+	thread_local int32 CachedVersion = -1;
+
+	FImGuiContextArena* GetCurrentArena()
+	{
+		if (ScopeArena || bNeutralScope)
+		{
+			return ScopeArena;
+		}
+
+		ImGuiContext* Context = ImGui::GetCurrentContext();
+		if (Context != CachedContext || CachedVersion != ContextArenasVersion.GetValue())
+		{
+			FScopeLock ScopeLock(&ContextArenasLock);
+			CachedContext = Context;
+			CachedArena = Context ? ContextArenas.FindRef(Context) : nullptr;
+			CachedVersion = ContextArenasVersion.GetValue();
+		}
+
+		return CachedArena;
+	}
+}
+
+FImGuiContextArena::FScope::FScope(FImGuiContextArena& Arena)
+	: PreviousArena(ScopeArena)
+	, bPreviousNeutral(bNeutralScope)
+{
+	ScopeArena = &Arena;
+	bNeutralScope = false;
+}
+
+FImGuiContextArena::FScope::~FScope()
+{
+	ScopeArena = PreviousArena;
+	bNeutralScope = bPreviousNeutral;
+}
+
+FImGuiContextArena::FNeutralScope::FNeutralScope()
+	: PreviousArena(ScopeArena)
+	, bPreviousNeutral(bNeutralScope)
+{
+	ScopeArena = nullptr;
+	bNeutralScope = true;
+}
+
+FImGuiContextArena::FNeutralScope::~FNeutralScope()
+{
+	ScopeArena = PreviousArena;
+	bNeutralScope = bPreviousNeutral;
+}
+
+FImGuiContextArena::~FImGuiContextArena()
+{
+	UnbindContext();
+
+	// Data that outlive the context can be released after it is unbound.
+	ReclaimRemoteBlocks();
+
+	// Context should release all its allocations before arena is destroyed. Retained large blocks are allocated
+	// separately, while remaining blocks in pages are released together with pages.
+	for (int32 SizeClass = NumPageSizeClasses; SizeClass < NumSizeClasses; SizeClass++)
+	{
+		while (FFreeBlock* Block = FreeLists[SizeClass])
+		{
+			FreeLists[SizeClass] = Block->Next;
+			FMemory::Free(Block);
+		}
+	}
+
+	for (void* Page : Pages)
+	{
+		FMemory::Free(Page);
+	}
+}
+
+void FImGuiContextArena::InstallAllocator()
+{
+	static_assert(sizeof(FAllocationHeader) <= HeaderSize, "Allocation header doesn't fit in the reserved space.");
+	static_assert(sizeof(FFreeBlock) <= MinBlockSize, "Free block doesn't fit in the smallest block.");
+
+	ImGui::SetAllocatorFunctions(&FImGuiContextArena::AllocateFunction, &FImGuiContextArena::FreeFunction);
+}
+
+void FImGuiContextArena::BindContext(ImGuiContext* Context)
+{
+	UnbindContext();
+
+	if (Context)
+	{
+		FScopeLock ScopeLock(&ContextArenasLock);
+		ContextArenas.Add(Context, this);
+		ContextArenasVersion.Increment();
+		BoundContext = Context;
+	}
+}
+
+void FImGuiContextArena::UnbindContext()
+{
+	if (BoundContext)
+	{
+		FScopeLock ScopeLock(&ContextArenasLock);
+		ContextArenas.Remove(BoundContext);
+		ContextArenasVersion.Increment();
+		BoundContext = nullptr;
+	}
+}
+
+void FImGuiContextArena::ResetFrameStats()
+{
+	ReclaimRemoteBlocks();
+
+	Stats.NumFrameAllocations = NumFrameAllocations;
+	Stats.NumFrameSystemAllocations = NumFrameSystemAllocations;
+	NumFrameAllocations = 0;
+	NumFrameSystemAllocations = 0;
+}
+
+void* FImGuiContextArena::AllocateFunction(size_t Size, void* UserData)
+{
+	if (FImGuiContextArena* Arena = GetCurrentArena())
+	{
+		return Arena->Allocate(Size);
+	}
+
+	FAllocationHeader* Header = static_cast<FAllocationHeader*>(FMemory::Malloc(Size + HeaderSize));
+	Header->Arena = nullptr;
+	Header->Size = static_cast<uint32>(Size);
+	Header->SizeClass = INDEX_NONE;
+	return reinterpret_cast<uint8*>(Header) + HeaderSize;
+}
+
+void FImGuiContextArena::FreeFunction(void* Ptr, void* UserData)
+{
+	if (Ptr)
+	{
+		FAllocationHeader* Header = reinterpret_cast<FAllocationHeader*>(static_cast<uint8*>(Ptr) - HeaderSize);
+		if (!Header->Arena)
+		{
+			FMemory::Free(Header);
+		}
+		else if (Header->Arena == GetCurrentArena())
+		{
+			Header->Arena->Free(Header);
+		}
+		else
+		{
+			Header->Arena->FreeRemote(Header);
+		}
+	}
+}
+
+void* FImGuiContextArena::Allocate(SIZE_T Size)
+{
+	const SIZE_T BlockSize = Size + HeaderSize;
+	const int32 SizeClass = GetSizeClass(BlockSize);
+
+	FAllocationHeader* Header;
+	if (SizeClass < NumSizeClasses)
+	{
+		if (!FreeLists[SizeClass])
+		{
+			ReclaimRemoteBlocks();
+		}
+
+		if (FFreeBlock* Block = FreeLists[SizeClass])
+		{
+			FreeLists[SizeClass] = Block->Next;
+			Header = reinterpret_cast<FAllocationHeader*>(Block);
+
+			if (SizeClass >= NumPageSizeClasses)
+			{
+				RetainedBytes -= GetBlockSize(SizeClass);
+			}
+		}
+		else if (SizeClass < NumPageSizeClasses)
+		{
+			AddPage(SizeClass);
+
+			Header = reinterpret_cast<FAllocationHeader*>(FreeLists[SizeClass]);
+			FreeLists[SizeClass] = FreeLists[SizeClass]->Next;
+		}
+		else
+		{
+			IMGUI_LLM_SCOPE(Context);
+
+			Header = static_cast<FAllocationHeader*>(FMemory::Malloc(GetBlockSize(SizeClass)));
+
+			Stats.ReservedBytes += GetBlockSize(SizeClass);
+			NumFrameSystemAllocations++;
+		}
+
+		Header->SizeClass = SizeClass;
+	}
+	else
+	{
+		IMGUI_LLM_SCOPE(Context);
+
+		Header = static_cast<FAllocationHeader*>(FMemory::Malloc(BlockSize));
+		Header->SizeClass = INDEX_NONE;
+
+		Stats.ReservedBytes += BlockSize;
+		NumFrameSystemAllocations++;
+	}
+
+	Header->Arena = this;
+	Header->Size = static_cast<uint32>(Size);
+
+	Stats.AllocatedBytes += Size;
+	Stats.PeakAllocatedBytes = FMath::Max(Stats.PeakAllocatedBytes, Stats.AllocatedBytes);
+	Stats.NumAllocations++;
+	NumFrameAllocations++;
+
+	return reinterpret_cast<uint8*>(Header) + HeaderSize;
+}
+
+void FImGuiContextArena::Free(FAllocationHeader* Header)
+{
+	Stats.AllocatedBytes -= Header->Size;
+	Stats.NumAllocations--;
+
+	const int32 SizeClass = Header->SizeClass;
+	if (SizeClass == INDEX_NONE)
+	{
+		Stats.ReservedBytes -= Header->Size + HeaderSize;
+		FMemory::Free(Header);
+	}
+	else if (SizeClass >= NumPageSizeClasses && RetainedBytes + GetBlockSize(SizeClass) > MaxRetainedBytes)
+	{
+		Stats.ReservedBytes -= GetBlockSize(SizeClass);
+		FMemory::Free(Header);
+	}
+	else
+	{
+		if (SizeClass >= NumPageSizeClasses)
+		{
+			RetainedBytes += GetBlockSize(SizeClass);
+		}
+
+		FFreeBlock* Block = reinterpret_cast<FFreeBlock*>(Header);
+		Block->Next = FreeLists[SizeClass];
+		FreeLists[SizeClass] = Block;
+	}
+}
+
+void FImGuiContextArena::FreeRemote(FAllocationHeader* Header)
+{
+	FAllocationHeader* Head;
+	do
+	{
+		Head = RemoteBlocks;
+		Header->NextRemote = Head;
+	}
+	while (FPlatformAtomics::InterlockedCompareExchangePointer((void**)&RemoteBlocks, Header, Head) != Head);
+}
+
+void FImGuiContextArena::ReclaimRemoteBlocks()
+{
+	// The whole list is taken at once, so blocks can be pushed by other threads in the meantime.
+	FAllocationHeader* Header = static_cast<FAllocationHeader*>(
+		FPlatformAtomics::InterlockedExchangePtr((void**)&RemoteBlocks, nullptr));
+
+	while (Header)
+	{
+		FAllocationHeader* Next = Header->NextRemote;
+		Free(Header);
+		Header = Next;
+	}
+}
+
+void FImGuiContextArena::AddPage(int32 SizeClass)
+{
+	// Page is divided into blocks of one size class, which are added to the free list.
+	const SIZE_T BlockSize = GetBlockSize(SizeClass);
+	const SIZE_T NumBlocks = PageSize / BlockSize;
+
+	IMGUI_LLM_SCOPE(Context);
+
+	uint8* Page = static_cast<uint8*>(FMemory::Malloc(PageSize));
+	Pages.Add(Page);
+
+	for (SIZE_T BlockIndex = NumBlocks; BlockIndex > 0; BlockIndex--)
+	{
+		FFreeBlock* Block = reinterpret_cast<FFreeBlock*>(Page + (BlockIndex - 1) * BlockSize);
+		Block->Next = FreeLists[SizeClass];
+		FreeLists[SizeClass] = Block;
+	}
+
+	Stats.ReservedBytes += PageSize;
+	NumFrameSystemAllocations++;
+}
@@ -0,0 +1,144 @@
+// Distributed under the MIT License (MIT) (see accompanying LICENSE file)
+
+#pragma once
+
+#include <Containers/Array.h>
+
+
+struct ImGuiContext;
+
+// Memory arena for allocations made by a single ImGui context. Small allocations are served from per-size free lists
+// backed by pages kept for the lifetime of the arena. Larger allocations, like draw list buffers, are rounded up to
+// a power of two and released blocks are kept in per-size free lists for reuse, up to a limit. In a steady state,
+// ImGui doesn't need to call the engine allocator. Only very large allocations are always passed to the engine
+// allocator, but they are still tracked by the arena.
+// Every allocation stores its owning arena, so it can be released regardless of the context that is current.
+// ImGui contexts are never updated by more than one thread at a time, so an arena is only used by the thread in which
+// it is current and it doesn't need locks. Blocks released in threads where a different arena is current are passed
+// to the owning arena through a lock-free list and reused after the owning arena becomes current again.
+class FImGuiContextArena
+{
+public:
+
+	// Memory statistics of an arena.
+	struct FStats
+	{
+		// Bytes requested in live allocations.
+		SIZE_T AllocatedBytes = 0;
+
+		// The highest number of bytes requested in live allocations.
+		SIZE_T PeakAllocatedBytes = 0;
+
+		// Bytes reserved from the engine allocator, including pages and large allocations.
+		SIZE_T ReservedBytes = 0;
+
+		// Number of live allocations.
+		uint32 NumAllocations = 0;
+
+		// Number of allocations made in the last frame.
+		uint32 NumFrameAllocations = 0;
+
+		// Number of calls to the engine allocator made in the last frame.
+		uint32 NumFrameSystemAllocations = 0;
+	};
+
+	// Allocations made in the current thread within this scope use the given arena, regardless of the current
+	// context. This allows to track allocations made before a context is set as current (e.g. during creation).
+	class FScope
+	{
+	public:
+
+		FScope(FImGuiContextArena& Arena);
+		~FScope();
+
+		FScope(const FScope&) = delete;
+		FScope& operator=(const FScope&) = delete;
+
+	private:
+
+		FImGuiContextArena* PreviousArena = nullptr;
+		bool bPreviousNeutral = false;
+	};
+
+	// Allocations made in the current thread within this scope are passed to the engine allocator, regardless of
+	// the current context. This allows to build shared resources (e.g. font atlas) in any thread, without counting
+	// them in a context that is current there.
+	class FNeutralScope
+	{
+	public:
+
+		FNeutralScope();
+		~FNeutralScope();
+
+		FNeutralScope(const FNeutralScope&) = delete;
+		FNeutralScope& operator=(const FNeutralScope&) = delete;
+
+	private:
+
+		FImGuiContextArena* PreviousArena = nullptr;
+		bool bPreviousNeutral = false;
+	};
+
+	FImGuiContextArena() = default;
+	~FImGuiContextArena();
+
+	FImGuiContextArena(const FImGuiContextArena&) = delete;
+	FImGuiContextArena& operator=(const FImGuiContextArena&) = delete;
+
+	FImGuiContextArena(FImGuiContextArena&&) = delete;
+	FImGuiContextArena& operator=(FImGuiContextArena&&) = delete;
+
+	// Set ImGui allocator functions that use arenas. It should be called before ImGui allocates any memory. Allocations
+	// made while no context with a bound arena is current are passed to the engine allocator.
+	static void InstallAllocator();
+
+	// Bind this arena to a context, so allocations made while that context is current will use this arena.
+	// @param Context - ImGui context that should use this arena
+	void BindContext(ImGuiContext* Context);
+
+	// Unbind this arena from its context. Allocations made by this arena can be still released.
+	void UnbindContext();
+
+	// Finish counting allocations in the current frame and start counting them in a new one. This also reclaims blocks
+	// released in other threads. It should be called in the thread in which the context is updated.
+	void ResetFrameStats();
+
+	// Get memory statistics of this arena. It should not be called while the context is updated in a different thread.
+	FStats GetStats() const { return Stats; }
+
+private:
+
+	struct FAllocationHeader;
+	struct FFreeBlock;
+
+	// Size classes with blocks allocated in pages (up to 8 KB) and all size classes (up to 512 MB).
+	static constexpr int32 NumPageSizeClasses = 9;
+	static constexpr int32 NumSizeClasses = 25;
+
+	static void* AllocateFunction(size_t Size, void* UserData);
+	static void FreeFunction(void* Ptr, void* UserData);
+
+	void* Allocate(SIZE_T Size);
+	void Free(FAllocationHeader* Header);
+
+	// Pass a block released in a thread in which this arena is not current.
+	void FreeRemote(FAllocationHeader* Header);
+
+	// Release blocks passed from other threads.
+	void ReclaimRemoteBlocks();
+
+	void AddPage(int32 SizeClass);
+
+	FFreeBlock* FreeLists[NumSizeClasses] = {};
+	TArray<void*> Pages;
+
+	// Blocks released in other threads, which are waiting to be reclaimed.
+	FAllocationHeader* volatile RemoteBlocks = nullptr;
+
+	FStats Stats;
+	SIZE_T RetainedBytes = 0;
+	uint32 NumFrameAllocations = 0;
+	uint32 NumFrameSystemAllocations = 0;
+
+	ImGuiContext* BoundContext = nullptr;
+};
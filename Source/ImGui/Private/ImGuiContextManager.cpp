@@ -2,19 +2,60 @@
 
 #include "ImGuiContextManager.h"
 
+#include "ImGuiContextArena.h"
 #include "ImGuiDelegatesContainer.h"
+#include "ImGuiFontAtlasCache.h"
 #include "ImGuiImplementation.h"
+#include "ImGuiModuleDebug.h"
 #include "ImGuiModuleSettings.h"
 #include "Utilities/WorldContext.h"
 #include "Utilities/WorldContextIndex.h"
 
+#include <Async/ParallelFor.h>
+#include <Async/TaskGraphInterfaces.h>
+#include <HAL/IConsoleManager.h>
+#include <Misc/FileHelper.h>
+#include <Misc/Paths.h>
+
 #include <imgui.h>
 
 
 // TODO: Refactor ImGui Context Manager, to handle different types of worlds.
 
+#if IMGUI_THREAD_LOCAL_CONTEXT
+namespace CVars
+{
+	TAutoConsoleVariable<int> ParallelContextTick(TEXT("ImGui.ParallelContextTick"), 1,
+		TEXT("Whether contexts should be updated in parallel (debug delegates are still called on the game thread).\n")
+		TEXT("0: disabled\n")
+		TEXT("1: enabled (default)"),
+		ECVF_Default);
+}
+#endif // IMGUI_THREAD_LOCAL_CONTEXT
+
+namespace CVars
+{
+	TAutoConsoleVariable<int> MaxDynamicGlyphs(TEXT("ImGui.FontAtlas.MaxDynamicGlyphs"), 4096,
+		TEXT("Maximum number of glyphs requested with FImGuiModule::RequestFontGlyphs that are kept in the font atlas.\n")
+		TEXT("When exceeded, glyphs that were not drawn for the longest time are replaced by new glyphs."),
+		ECVF_Default);
+}
+
+DEFINE_LOG_CATEGORY_STATIC(LogImGuiFonts, Warning, All);
+
+DECLARE_CYCLE_STAT(TEXT("Context Manager Tick"), STAT_ImGui_ContextManagerTick, STATGROUP_ImGui);
+DECLARE_CYCLE_STAT(TEXT("Add Font Glyphs"), STAT_ImGui_AddFontGlyphs, STATGROUP_ImGui);
+DECLARE_CYCLE_STAT(TEXT("Find Drawn Font Glyphs"), STAT_ImGui_FindDrawnFontGlyphs, STATGROUP_ImGui);
+
 namespace
 {
+	// Smallest number of cells for dynamic glyphs reserved in the font atlas. The number of cells is doubled when they
+	// are all taken, until it reaches ImGui.FontAtlas.MaxDynamicGlyphs.
+	constexpr int32 MinDynamicGlyphsCapacity = 64;
+
+	// Maximum number of glyphs rasterized in one tick, to avoid hitches when a lot of new text is shown at once.
+	constexpr int32 MaxGlyphsAddedPerTick = 128;
+
 #if WITH_EDITOR
 
 	// Name for editor ImGui context.
@@ -55,14 +96,89 @@ namespace
 	}
 
 #endif // WITH_EDITOR
+
+	SIZE_T CalculateFontAtlasMemory(const ImFontAtlas& FontAtlas)
+	{
+		SIZE_T Bytes = 0;
+
+		const SIZE_T NumPixels = static_cast<SIZE_T>(FontAtlas.TexWidth) * FontAtlas.TexHeight;
+		if (FontAtlas.TexPixelsAlpha8)
+		{
+			Bytes += NumPixels;
+		}
+		if (FontAtlas.TexPixelsRGBA32)
+		{
+			Bytes += NumPixels * 4;
+		}
+
+		for (const ImFont* Font : FontAtlas.Fonts)
+		{
+			Bytes += Font->Glyphs.size_in_bytes() + Font->IndexLookup.size_in_bytes() + Font->IndexAdvanceX.size_in_bytes();
+		}
+
+		for (const ImFontConfig& Config : FontAtlas.ConfigData)
+		{
+			if (Config.FontDataOwnedByAtlas)
+			{
+				Bytes += Config.FontDataSize;
+			}
+		}
+
+		return Bytes;
+	}
+
+	// Add the default font scaled for the given DPI scale and build the atlas with Alpha8 pixels. RGBA32 pixels are kept
+	// by ImGui until the atlas is destroyed, so we only expand them temporarily when creating the atlas texture. If
+	// possible, the atlas is loaded from the cache instead of rasterizing fonts. Cells for dynamic glyphs are reserved
+	// before the build, so atlases with the same number of cells can be cached, and glyphs are added after that.
+	// @param FontAtlas - Empty font atlas
+	// @param Scale - DPI scale
+	// @param Glyphs - Receives dynamic glyphs added to the atlas
+	// @param GlyphsCapacity - Number of cells reserved for dynamic glyphs
+	// @param GlyphFontData - If not null, data of a font from which dynamic glyphs are added
+	// @param Codepoints - Dynamic glyphs to add, in order of priority
+	void BuildFontAtlasPixels(ImFontAtlas& FontAtlas, float Scale, FImGuiDynamicGlyphs& Glyphs, int32 GlyphsCapacity,
+		const TArray<uint8>* GlyphFontData, const TArray<ImWchar>& Codepoints)
+	{
+		// Font atlas is shared by all contexts, so its allocations should not be counted by a context that is current
+		// in this thread.
+		FImGuiContextArena::FNeutralScope NeutralArenaScope;
+
+		ImFontConfig FontConfig = {};
+		FontConfig.SizePixels = FMath::RoundFromZero(13.f * Scale);
+		FontAtlas.AddFontDefault(&FontConfig);
+
+		Glyphs.Reserve(FontAtlas, GlyphsCapacity);
+
+		if (!ImGuiFontAtlasCache::Load(FontAtlas))
+		{
+			unsigned char* Pixels;
+			int Width, Height;
+			FontAtlas.GetTexDataAsAlpha8(&Pixels, &Width, &Height);
+
+			ImGuiFontAtlasCache::Save(FontAtlas);
+		}
+
+		Glyphs.Bind(FontAtlas);
+
+		if (GlyphFontData && Codepoints.Num() > 0)
+		{
+			TArray<ImWchar> MissingCodepoints;
+			Glyphs.AddGlyphs(FontAtlas, *GlyphFontData, Codepoints, MissingCodepoints);
+		}
+	}
 }
 
 FImGuiContextManager::FImGuiContextManager(FImGuiModuleSettings& InSettings)
 	: Settings(InSettings)
 {
 	Settings.OnDPIScaleChangedDelegate.AddRaw(this, &FImGuiContextManager::SetDPIScale);
+	Settings.OnUpdateFrequencyChanged.AddRaw(this, &FImGuiContextManager::SetUpdateFrequency);
+	Settings.OnGlyphFontFileChanged.AddRaw(this, &FImGuiContextManager::SetGlyphFontFile);
 
 	SetDPIScale(Settings.GetDPIScaleInfo());
+	SetUpdateFrequency(Settings.GetUpdateFrequency());
+	SetGlyphFontFile(Settings.GetGlyphFontFile());
 	BuildFontAtlas();
 
 	FWorldDelegates::OnWorldTickStart.AddRaw(this, &FImGuiContextManager::OnWorldTickStart);
@@ -73,7 +189,15 @@ FImGuiContextManager::FImGuiContextManager(FImGuiModuleSettings& InSettings)
 
 FImGuiContextManager::~FImGuiContextManager()
 {
+	// Pending atlas is released together with this manager, so the build task needs to finish first.
+	if (PendingFontAtlasTask.IsValid())
+	{
+		FTaskGraphInterface::Get().WaitUntilTaskCompletes(PendingFontAtlasTask);
+	}
+
 	Settings.OnDPIScaleChangedDelegate.RemoveAll(this);
+	Settings.OnUpdateFrequencyChanged.RemoveAll(this);
+	Settings.OnGlyphFontFileChanged.RemoveAll(this);
 
 	// Order matters because contexts can be created during World Tick Start events.
 	FWorldDelegates::OnWorldTickStart.RemoveAll(this);
@@ -84,14 +208,36 @@ FImGuiContextManager::~FImGuiContextManager()
 
 void FImGuiContextManager::Tick(float DeltaSeconds)
 {
+	SCOPE_CYCLE_COUNTER(STAT_ImGui_ContextManagerTick);
+	IMGUI_TRACE_SCOPE("ImGui Context Manager Tick");
+
+	// Swap in a font atlas built in the background before contexts tick, so they can bind to it in this frame.
+	UpdatePendingFontAtlas();
+
+	// Glyphs are added here because no context is using the font at this point.
+	AddRequestedGlyphs();
+
 	// In editor, worlds can get invalid. We could remove corresponding entries, but that would mean resetting ImGui
 	// context every time when PIE session is restarted. Instead we freeze contexts until their worlds are re-created.
 
+#if IMGUI_THREAD_LOCAL_CONTEXT
+	const bool bParallelTick = CVars::ParallelContextTick.GetValueOnGameThread() > 0;
+	TArray<FImGuiContextProxy*, TInlineAllocator<8>> ProxiesToTick;
+#endif // IMGUI_THREAD_LOCAL_CONTEXT
+
 	for (auto& Pair : Contexts)
 	{
 		auto& ContextData = Pair.Value;
 		if (ContextData.CanTick())
 		{
+#if IMGUI_THREAD_LOCAL_CONTEXT
+			if (bParallelTick)
+			{
+				ProxiesToTick.Add(ContextData.ContextProxy.Get());
+				continue;
+			}
+#endif // IMGUI_THREAD_LOCAL_CONTEXT
+
 			ContextData.ContextProxy->Tick(DeltaSeconds);
 		}
 		else
@@ -101,12 +247,58 @@ void FImGuiContextManager::Tick(float DeltaSeconds)
 		}
 	}
 
+#if IMGUI_THREAD_LOCAL_CONTEXT
+	TickInParallel(ProxiesToTick, DeltaSeconds);
+#endif // IMGUI_THREAD_LOCAL_CONTEXT
+
+	UpdateDrawnGlyphs();
+
 	// Once all context tick they should use new fonts and we can release the old resources. Extra countdown is added
 	// wait for contexts that ticked outside of this function, before rebuilding fonts.
 	if (FontResourcesReleaseCountdown > 0 && !--FontResourcesReleaseCountdown)
 	{
 		FontResourcesToRelease.Empty();
 	}
+
+#if STATS
+	UpdateMemoryStats();
+#endif
+}
+
+#if IMGUI_THREAD_LOCAL_CONTEXT
+void FImGuiContextManager::TickInParallel(TArrayView<FImGuiContextProxy* const> Proxies, float DeltaSeconds)
+{
+	// Debug delegates are called on this thread. Calling tick will not broadcast them again.
+	for (FImGuiContextProxy* Proxy : Proxies)
+	{
+		Proxy->DrawDebug();
+	}
+
+	// Each task sets its context as current only for the thread in which it runs. Font atlas is shared by all contexts
+	// but it is only read during frames.
+	ParallelFor(Proxies.Num(), [&Proxies, DeltaSeconds](int32 Index)
+	{
+		ImGuiContext* PreviousContext = ImGui::GetCurrentContext();
+		Proxies[Index]->Tick(DeltaSeconds);
+		ImGui::SetCurrentContext(PreviousContext);
+	});
+}
+#endif // IMGUI_THREAD_LOCAL_CONTEXT
+
+SIZE_T FImGuiContextManager::GetFontAtlasMemory() const
+{
+	SIZE_T Bytes = CalculateFontAtlasMemory(FontAtlas);
+	for (const auto& OldFontAtlas : FontResourcesToRelease)
+	{
+		Bytes += CalculateFontAtlasMemory(*OldFontAtlas);
+	}
+	return Bytes;
+}
+
+SIZE_T FImGuiContextManager::GetFontAtlasSavedMemory() const
+{
+	return (FontAtlas.TexPixelsAlpha8 && !FontAtlas.TexPixelsRGBA32)
+		? static_cast<SIZE_T>(FontAtlas.TexWidth) * FontAtlas.TexHeight * 4 : 0;
 }
 
 #if ENGINE_COMPATIBILITY_LEGACY_WORLD_ACTOR_TICK
@@ -151,7 +343,7 @@ FImGuiContextManager::FContextData& FImGuiContextManager::GetEditorContextData()
 
 	if (UNLIKELY(!Data))
 	{
-		Data = &Contexts.Emplace(Utilities::EDITOR_CONTEXT_INDEX, FContextData{ GetEditorContextName(), Utilities::EDITOR_CONTEXT_INDEX, FontAtlas, DPIScale, -1 });
+		Data = &Contexts.Emplace(Utilities::EDITOR_CONTEXT_INDEX, FContextData{ GetEditorContextName(), Utilities::EDITOR_CONTEXT_INDEX, FontAtlas, DPIScale, UpdateFrequency, -1 });
 		OnContextProxyCreated.Broadcast(Utilities::EDITOR_CONTEXT_INDEX, *Data->ContextProxy);
 	}
 
@@ -166,7 +358,7 @@ FImGuiContextManager::FContextData& FImGuiContextManager::GetStandaloneWorldCont
 
 	if (UNLIKELY(!Data))
 	{
-		Data = &Contexts.Emplace(Utilities::STANDALONE_GAME_CONTEXT_INDEX, FContextData{ GetWorldContextName(), Utilities::STANDALONE_GAME_CONTEXT_INDEX, FontAtlas, DPIScale });
+		Data = &Contexts.Emplace(Utilities::STANDALONE_GAME_CONTEXT_INDEX, FContextData{ GetWorldContextName(), Utilities::STANDALONE_GAME_CONTEXT_INDEX, FontAtlas, DPIScale, UpdateFrequency });
 		OnContextProxyCreated.Broadcast(Utilities::STANDALONE_GAME_CONTEXT_INDEX, *Data->ContextProxy);
 	}
 
@@ -208,7 +400,7 @@ FImGuiContextManager::FContextData& FImGuiContextManager::GetWorldContextData(co
 #if WITH_EDITOR
 	if (UNLIKELY(!Data))
 	{
-		Data = &Contexts.Emplace(Index, FContextData{ GetWorldContextName(World), Index, FontAtlas, DPIScale, WorldContext->PIEInstance });
+		Data = &Contexts.Emplace(Index, FContextData{ GetWorldContextName(World), Index, FontAtlas, DPIScale, UpdateFrequency, WorldContext->PIEInstance });
 		OnContextProxyCreated.Broadcast(Index, *Data->ContextProxy);
 	}
 	else
@@ -219,7 +411,7 @@ FImGuiContextManager::FContextData& FImGuiContextManager::GetWorldContextData(co
 #else
 	if (UNLIKELY(!Data))
 	{
-		Data = &Contexts.Emplace(Index, FContextData{ GetWorldContextName(World), Index, FontAtlas, DPIScale });
+		Data = &Contexts.Emplace(Index, FContextData{ GetWorldContextName(World), Index, FontAtlas, DPIScale, UpdateFrequency });
 		OnContextProxyCreated.Broadcast(Index, *Data->ContextProxy);
 	}
 #endif
@@ -234,37 +426,205 @@ FImGuiContextManager::FContextData& FImGuiContextManager::GetWorldContextData(co
 void FImGuiContextManager::SetDPIScale(const FImGuiDPIScaleInfo& ScaleInfo)
 {
 	const float Scale = ScaleInfo.GetImGuiScale();
-	if (DPIScale != Scale)
+	if (RequestedDPIScale != Scale)
 	{
-		DPIScale = Scale;
+		RequestedDPIScale = Scale;
 
-		// Only rebuild font atlas if it is already built. Otherwise allow the other logic to pick a moment.
+		// Only rebuild font atlas if it is already built. Otherwise allow the other logic to pick a moment. Contexts
+		// switch to the new scale together with the new atlas.
 		if (FontAtlas.IsBuilt())
 		{
 			RebuildFontAtlas();
 		}
+		else
+		{
+			ApplyDPIScale(Scale);
+		}
+	}
+}
+
+void FImGuiContextManager::ApplyDPIScale(float Scale)
+{
+	DPIScale = Scale;
+
+	for (auto& Pair : Contexts)
+	{
+		if (Pair.Value.ContextProxy)
+		{
+			Pair.Value.ContextProxy->SetDPIScale(DPIScale);
+		}
+	}
+}
+
+void FImGuiContextManager::SetUpdateFrequency(float Frequency)
+{
+	if (UpdateFrequency != Frequency)
+	{
+		UpdateFrequency = Frequency;
 
 		for (auto& Pair : Contexts)
 		{
 			if (Pair.Value.ContextProxy)
 			{
-				Pair.Value.ContextProxy->SetDPIScale(DPIScale);
+				Pair.Value.ContextProxy->SetUpdateFrequency(UpdateFrequency);
 			}
 		}
 	}
 }
 
+void FImGuiContextManager::RequestGlyphs(const FString& Text)
+{
+	for (int32 Index = 0; Index < Text.Len(); Index++)
+	{
+		// Default font covers the first 256 characters. Surrogates are skipped because ImGui only supports characters
+		// from the basic multilingual plane.
+		const uint32 Codepoint = static_cast<uint32>(Text[Index]);
+		if (Codepoint < 0x100 || Codepoint > 0xFFFF || (Codepoint >= 0xD800 && Codepoint <= 0xDFFF))
+		{
+			continue;
+		}
+
+		// Glyphs in the atlas are only kept while they are drawn, so requesting them again is cheap. Without glyph font,
+		// requests are only recorded, so glyphs can be added when the font is set.
+		const ImWchar Glyph = static_cast<ImWchar>(Codepoint);
+		if (!DynamicGlyphs.Contains(Glyph) && !MissingGlyphs.Contains(Glyph))
+		{
+			RequestedGlyphs.Add(Glyph);
+		}
+	}
+}
+
+void FImGuiContextManager::SetGlyphFontFile(const FString& Filename)
+{
+	GlyphFontData.Reset();
+
+	if (!Filename.IsEmpty())
+	{
+#if ENGINE_COMPATIBILITY_LEGACY_SAVED_DIR
+		const FString ProjectDir = FPaths::GameDir();
+#else
+		const FString ProjectDir = FPaths::ProjectDir();
+#endif
+		const FString Path = FPaths::IsRelative(Filename) ? FPaths::Combine(*ProjectDir, *Filename) : Filename;
+
+		TSharedPtr<TArray<uint8>, ESPMode::ThreadSafe> Data = MakeShareable(new TArray<uint8>());
+		if (FFileHelper::LoadFileToArray(*Data, *Path))
+		{
+			GlyphFontData = Data;
+		}
+		else
+		{
+			UE_LOG(LogImGuiFonts, Warning, TEXT("Couldn't load glyph font '%s'."), *Path);
+		}
+	}
+
+	// Glyphs need to be rasterized again from the new font.
+	MissingGlyphs.Reset();
+	if (FontAtlas.IsBuilt() && DynamicGlyphs.Num() > 0)
+	{
+		RebuildFontAtlas();
+	}
+}
+
+void FImGuiContextManager::AddRequestedGlyphs()
+{
+	// Glyphs requested during a background build are added after the new atlas is swapped in.
+	const int32 MaxGlyphs = FMath::Max(CVars::MaxDynamicGlyphs.GetValueOnGameThread(), 0);
+	if (RequestedGlyphs.Num() == 0 || !GlyphFontData.IsValid() || !FontAtlas.IsBuilt() || PendingFontAtlas || MaxGlyphs == 0)
+	{
+		return;
+	}
+
+	// Cells are reserved before the atlas is built, so adding more cells needs a rebuild. Number of cells grows in
+	// powers of two, so atlas memory scales with the number of used glyphs and there are only a few rebuilds.
+	const int32 NumGlyphs = DynamicGlyphs.Num() + RequestedGlyphs.Num();
+	if (NumGlyphs > DynamicGlyphs.GetCapacity() && DynamicGlyphs.GetCapacity() < MaxGlyphs)
+	{
+		DynamicGlyphsCapacity = FMath::Min(MaxGlyphs,
+			FMath::Max(MinDynamicGlyphsCapacity, static_cast<int32>(FMath::RoundUpToPowerOfTwo(NumGlyphs))));
+		RebuildFontAtlas();
+		return;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_ImGui_AddFontGlyphs);
+	IMGUI_LLM_SCOPE(FontAtlas);
+
+	TArray<ImWchar> Codepoints;
+	for (ImWchar Codepoint : RequestedGlyphs)
+	{
+		Codepoints.Add(Codepoint);
+		if (Codepoints.Num() == MaxGlyphsAddedPerTick)
+		{
+			break;
+		}
+	}
+
+	TArray<ImWchar> MissingCodepoints;
+	const FIntRect UpdatedRect = DynamicGlyphs.AddGlyphs(FontAtlas, *GlyphFontData, Codepoints, MissingCodepoints);
+
+	// Glyphs that didn't fit, because other glyphs are still drawn, stay requested.
+	for (ImWchar Codepoint : Codepoints)
+	{
+		if (DynamicGlyphs.Contains(Codepoint))
+		{
+			RequestedGlyphs.Remove(Codepoint);
+		}
+	}
+
+	for (ImWchar Codepoint : MissingCodepoints)
+	{
+		RequestedGlyphs.Remove(Codepoint);
+		MissingGlyphs.Add(Codepoint);
+	}
+
+	if (UpdatedRect.Area() > 0)
+	{
+		OnFontAtlasUpdated.Broadcast(UpdatedRect);
+	}
+}
+
+void FImGuiContextManager::UpdateDrawnGlyphs()
+{
+	if (DynamicGlyphs.Num() == 0)
+	{
+		return;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_ImGui_FindDrawnFontGlyphs);
+
+	DynamicGlyphs.BeginDrawUpdate();
+
+	for (auto& Pair : Contexts)
+	{
+		FContextData& ContextData = Pair.Value;
+		const FImGuiContextProxy& ContextProxy = *ContextData.ContextProxy;
+
+		// Draw data of contexts that didn't update are the same, so glyphs found in them before are still drawn.
+		if (ContextData.DrawnGlyphsCellsVersion != DynamicGlyphsCellsVersion
+			|| ContextData.DrawnGlyphsDrawDataVersion != ContextProxy.GetDrawDataVersion())
+		{
+			ContextData.DrawnGlyphsCellsVersion = DynamicGlyphsCellsVersion;
+			ContextData.DrawnGlyphsDrawDataVersion = ContextProxy.GetDrawDataVersion();
+
+			ContextData.DrawnGlyphCells.Init(false, DynamicGlyphs.GetCapacity());
+			for (const FImGuiDrawList& DrawList : ContextProxy.GetDrawData())
+			{
+				DynamicGlyphs.FindDrawnGlyphs(DrawList, FontAtlas.TexID, ContextData.DrawnGlyphCells);
+			}
+		}
+
+		DynamicGlyphs.MarkDrawn(ContextData.DrawnGlyphCells);
+	}
+}
+
 void FImGuiContextManager::BuildFontAtlas()
 {
 	if (!FontAtlas.IsBuilt())
 	{
-		ImFontConfig FontConfig = {};
-		FontConfig.SizePixels = FMath::RoundFromZero(13.f * DPIScale);
-		FontAtlas.AddFontDefault(&FontConfig);
+		IMGUI_LLM_SCOPE(FontAtlas);
 
-		unsigned char* Pixels;
-		int Width, Height, Bpp;
-		FontAtlas.GetTexDataAsRGBA32(&Pixels, &Width, &Height, &Bpp);
+		BuildFontAtlasPixels(FontAtlas, DPIScale, DynamicGlyphs, DynamicGlyphsCapacity, GlyphFontData.Get(),
+			RequestedGlyphs.Array());
 
 		OnFontAtlasBuilt.Broadcast();
 	}
@@ -272,16 +632,129 @@ void FImGuiContextManager::BuildFontAtlas()
 
 void FImGuiContextManager::RebuildFontAtlas()
 {
-	if (FontAtlas.IsBuilt())
+	// If there is a build in progress, the scale, cells and glyph font are checked again after it finishes.
+	if (!PendingFontAtlas)
 	{
-		// Keep the old resources alive for a few frames to give all contexts a chance to bind to new ones.
-		FontResourcesToRelease.Add(TUniquePtr<ImFontAtlas>(new ImFontAtlas()));
-		Swap(*FontResourcesToRelease.Last(), FontAtlas);
+		BuildFontAtlasAsync(RequestedDPIScale);
+	}
+}
+
+void FImGuiContextManager::SwapFontAtlas(TUniquePtr<ImFontAtlas> NewFontAtlas, float Scale)
+{
+	// Keep the old resources alive for a few frames to give all contexts a chance to bind to new ones.
+	FontResourcesToRelease.Add(MoveTemp(NewFontAtlas));
+	ImFontAtlas& OldFontAtlas = *FontResourcesToRelease.Last();
+	Swap(OldFontAtlas, FontAtlas);
 
-		// Typically, one frame should be enough but since we allow for custom ticking, we need at least to frames to
-		// wait for contexts that already ticked and will not do that before the end of the next tick of this manager.
-		FontResourcesReleaseCountdown = 3;
+	// Cells of dynamic glyphs are at different positions in the new atlas.
+	DynamicGlyphsCellsVersion++;
+
+	// Fonts keep pointers to their atlases, which need to be updated after swapping.
+	for (ImFont* Font : FontAtlas.Fonts)
+	{
+		Font->ContainerAtlas = &FontAtlas;
+	}
+	for (ImFont* Font : OldFontAtlas.Fonts)
+	{
+		Font->ContainerAtlas = &OldFontAtlas;
 	}
 
-	BuildFontAtlas();
+	// Typically, one frame should be enough but since we allow for custom ticking, we need at least to frames to
+	// wait for contexts that already ticked and will not do that before the end of the next tick of this manager.
+	FontResourcesReleaseCountdown = 3;
+
+	ApplyDPIScale(Scale);
+
+	// Texture is updated in the same tick, so contexts switch to the new atlas and texture at the same time.
+	OnFontAtlasBuilt.Broadcast();
+}
+
+void FImGuiContextManager::BuildFontAtlasAsync(float Scale)
+{
+	PendingFontAtlas.Reset(new ImFontAtlas());
+	PendingDynamicGlyphs.Reset(new FImGuiDynamicGlyphs());
+	PendingFontAtlasScale = Scale;
+	PendingDynamicGlyphsCapacity = DynamicGlyphsCapacity;
+	PendingGlyphFontData = GlyphFontData;
+
+	// Glyphs from the current atlas are added again, starting from the most recently drawn (if there are less cells,
+	// the least recently drawn glyphs are dropped). Requested glyphs are added after them.
+	TArray<ImWchar> Codepoints = DynamicGlyphs.GetCodepointsByLastDraw();
+	Codepoints.Append(RequestedGlyphs.Array());
+
+	// Glyph font data are shared, so they stay valid even if the font is changed during the build.
+	ImFontAtlas* NewFontAtlas = PendingFontAtlas.Get();
+	FImGuiDynamicGlyphs* NewGlyphs = PendingDynamicGlyphs.Get();
+	const int32 GlyphsCapacity = DynamicGlyphsCapacity;
+	TSharedPtr<TArray<uint8>, ESPMode::ThreadSafe> FontData = GlyphFontData;
+	PendingFontAtlasTask = FFunctionGraphTask::CreateAndDispatchWhenReady(
+		[NewFontAtlas, NewGlyphs, Scale, GlyphsCapacity, FontData, Codepoints]()
+	{
+		IMGUI_LLM_SCOPE(FontAtlas);
+
+		// Allocations are made under a neutral arena scope, so they don't depend on the current context. Building
+		// the atlas doesn't otherwise use the context, except for allocation counters shown in ImGui metrics. With
+		// thread-local context, those are also kept away from a context that was left as current in this thread.
+#if IMGUI_THREAD_LOCAL_CONTEXT
+		ImGuiContext* PreviousContext = ImGui::GetCurrentContext();
+		ImGui::SetCurrentContext(nullptr);
+#endif // IMGUI_THREAD_LOCAL_CONTEXT
+
+		BuildFontAtlasPixels(*NewFontAtlas, Scale, *NewGlyphs, GlyphsCapacity, FontData.Get(), Codepoints);
+
+#if IMGUI_THREAD_LOCAL_CONTEXT
+		ImGui::SetCurrentContext(PreviousContext);
+#endif // IMGUI_THREAD_LOCAL_CONTEXT
+	}, TStatId(), nullptr, ENamedThreads::AnyThread);
+}
+
+void FImGuiContextManager::UpdatePendingFontAtlas()
+{
+	if (PendingFontAtlasTask.IsValid() && PendingFontAtlasTask->IsComplete())
+	{
+		IMGUI_LLM_SCOPE(FontAtlas);
+
+		PendingFontAtlasTask = nullptr;
+
+		// Glyphs drawn during the build keep their order.
+		PendingDynamicGlyphs->CopyDrawOrder(DynamicGlyphs);
+		DynamicGlyphs = MoveTemp(*PendingDynamicGlyphs);
+		PendingDynamicGlyphs.Reset();
+
+		for (auto It = RequestedGlyphs.CreateIterator(); It; ++It)
+		{
+			if (DynamicGlyphs.Contains(*It))
+			{
+				It.RemoveCurrent();
+			}
+		}
+
+		SwapFontAtlas(MoveTemp(PendingFontAtlas), PendingFontAtlasScale);
+
+		// Scale, number of cells or glyph font could change while the atlas was built.
+		const bool bGlyphFontChanged = PendingGlyphFontData != GlyphFontData;
+		PendingGlyphFontData.Reset();
+		if (PendingFontAtlasScale != RequestedDPIScale || PendingDynamicGlyphsCapacity != DynamicGlyphsCapacity
+			|| bGlyphFontChanged)
+		{
+			BuildFontAtlasAsync(RequestedDPIScale);
+		}
+	}
+}
+
+void FImGuiContextManager::UpdateMemoryStats()
+{
+	SIZE_T ContextBytes = 0;
+	SIZE_T DrawDataBytes = 0;
+	for (const auto& Pair : Contexts)
+	{
+		const FImGuiContextProxy::FMemoryStats Stats = Pair.Value.ContextProxy->GetMemoryStats();
+		ContextBytes += Stats.ContextBytes;
+		DrawDataBytes += Stats.DrawDataBytes + Stats.PaintBufferBytes;
+	}
+
+	SET_MEMORY_STAT(STAT_ImGui_ContextMemory, ContextBytes);
+	SET_MEMORY_STAT(STAT_ImGui_DrawDataMemory, DrawDataBytes);
+	SET_MEMORY_STAT(STAT_ImGui_FontAtlasMemory, GetFontAtlasMemory());
+	SET_MEMORY_STAT(STAT_ImGui_FontAtlasSavedMemory, GetFontAtlasSavedMemory());
 }
@@ -3,8 +3,14 @@
 #pragma once
 
 #include "ImGuiContextProxy.h"
+#include "ImGuiDynamicGlyphs.h"
 #include "VersionCompatibility.h"
 
+#include <Async/TaskGraphInterfaces.h>
+#include <Containers/ArrayView.h>
+#include <Containers/BitArray.h>
+#include <Containers/Set.h>
+
 
 class FImGuiModuleSettings;
 struct FImGuiDPIScaleInfo;
@@ -17,6 +23,10 @@ struct FImGuiDPIScaleInfo;
 // @param ContextProxy - Created context proxy
 DECLARE_MULTICAST_DELEGATE_TwoParams(FContextProxyCreatedDelegate, int32, FImGuiContextProxy&);
 
+// Delegate called when a part of the font atlas is updated without rebuilding it.
+// @param Rect - Updated rectangle in font atlas pixels
+DECLARE_MULTICAST_DELEGATE_OneParam(FFontAtlasUpdatedDelegate, const FIntRect&);
+
 // Manages ImGui context proxies.
 class FImGuiContextManager
 {
@@ -58,28 +68,70 @@ public:
 		return Data ? Data->ContextProxy.Get() : nullptr;
 	}
 
+	// Call a function for every context proxy.
+	// @param Function - Function taking context index and context proxy
+	template<typename FunctionType>
+	void ForEachContextProxy(FunctionType Function) const
+	{
+		for (const auto& Pair : Contexts)
+		{
+			Function(Pair.Key, *Pair.Value.ContextProxy);
+		}
+	}
+
+	// Get the number of bytes used by the font atlas, including glyph data and texture pixels. Includes old atlases
+	// waiting to be released.
+	SIZE_T GetFontAtlasMemory() const;
+
+	// Get the number of bytes of CPU memory saved by keeping font atlas pixels in Alpha8 format, compared to RGBA32
+	// pixels which ImGui would keep in addition to Alpha8 pixels. Font atlas texture is still RGBA32, but RGBA32 pixels
+	// are only expanded to transient buffers released after uploads, so there are no other CPU copies to subtract.
+	SIZE_T GetFontAtlasSavedMemory() const;
+
+	// Request glyphs for characters from the given text. Glyphs missing in the font atlas are added from the glyph font
+	// in one of the next ticks. Should be called from the game thread.
+	// @param Text - Text with requested characters
+	void RequestGlyphs(const FString& Text);
+
 	// Delegate called when a new context proxy is created.
 	FContextProxyCreatedDelegate OnContextProxyCreated;
 
 	// Delegate called after font atlas is built.
 	FSimpleMulticastDelegate OnFontAtlasBuilt;
 
+	// Delegate called after glyphs are added to the font atlas.
+	FFontAtlasUpdatedDelegate OnFontAtlasUpdated;
+
 	void Tick(float DeltaSeconds);
 
+#if IMGUI_THREAD_LOCAL_CONTEXT
+	// Update context proxies in parallel. Debug delegates can access game objects, so they are called on the calling
+	// thread before the parallel update.
+	// @param Proxies - Context proxies to update
+	// @param DeltaSeconds - Time passed since the last update
+	static void TickInParallel(TArrayView<FImGuiContextProxy* const> Proxies, float DeltaSeconds);
+#endif // IMGUI_THREAD_LOCAL_CONTEXT
+
 private:
 
 	struct FContextData
 	{
-		FContextData(const FString& ContextName, int32 ContextIndex, ImFontAtlas& FontAtlas, float DPIScale, int32 InPIEInstance = -1)
+		FContextData(const FString& ContextName, int32 ContextIndex, ImFontAtlas& FontAtlas, float DPIScale, float UpdateFrequency, int32 InPIEInstance = -1)
 			: PIEInstance(InPIEInstance)
 			, ContextProxy(new FImGuiContextProxy(ContextName, ContextIndex, &FontAtlas, DPIScale))
 		{
+			ContextProxy->SetUpdateFrequency(UpdateFrequency);
 		}
 
 		FORCEINLINE bool CanTick() const { return PIEInstance < 0 || GEngine->GetWorldContextFromPIEInstance(PIEInstance); }
 
 		int32 PIEInstance = -1;
 		TUniquePtr<FImGuiContextProxy> ContextProxy;
+
+		// Cells of dynamic glyphs found in the draw data of this context, with versions of the draw data and of cells.
+		TBitArray<> DrawnGlyphCells;
+		uint32 DrawnGlyphsDrawDataVersion = 0;
+		uint32 DrawnGlyphsCellsVersion = 0;
 	};
 
 #if ENGINE_COMPATIBILITY_LEGACY_WORLD_ACTOR_TICK
@@ -102,16 +154,63 @@ private:
 	FContextData& GetWorldContextData(const UWorld& World, int32* OutContextIndex = nullptr);
 
 	void SetDPIScale(const FImGuiDPIScaleInfo& ScaleInfo);
+	void ApplyDPIScale(float Scale);
+	void SetUpdateFrequency(float Frequency);
+	void SetGlyphFontFile(const FString& Filename);
+
+	// Add requested glyphs to the font atlas. If there are not enough cells, the atlas is rebuilt with more cells.
+	void AddRequestedGlyphs();
+
+	// Find dynamic glyphs drawn by contexts, so glyphs that are not drawn can be replaced.
+	void UpdateDrawnGlyphs();
+
 	void BuildFontAtlas();
 	void RebuildFontAtlas();
+	void SwapFontAtlas(TUniquePtr<ImFontAtlas> NewFontAtlas, float Scale);
+
+	// Build a new font atlas in a background task, while contexts keep using the current one.
+	void BuildFontAtlasAsync(float Scale);
+
+	// If the background build is finished, swap in the new font atlas.
+	void UpdatePendingFontAtlas();
+
+	void UpdateMemoryStats();
 
 	TMap<int32, FContextData> Contexts;
 
 	ImFontAtlas FontAtlas;
 	TArray<TUniquePtr<ImFontAtlas>> FontResourcesToRelease;
 
+	// Data of a font with glyphs added on demand, shared with background builds.
+	TSharedPtr<TArray<uint8>, ESPMode::ThreadSafe> GlyphFontData;
+
+	// Glyphs added on demand to the current font atlas.
+	FImGuiDynamicGlyphs DynamicGlyphs;
+
+	// Requested glyphs which are not in the font atlas yet, and glyphs which are not in the glyph font.
+	TSet<ImWchar> RequestedGlyphs;
+	TSet<ImWchar> MissingGlyphs;
+
+	// Number of cells for dynamic glyphs reserved in the next font atlas build.
+	int32 DynamicGlyphsCapacity = 0;
+
+	// Version of cells of dynamic glyphs, changed when a new font atlas is swapped in.
+	uint32 DynamicGlyphsCellsVersion = 1;
+
+	// Font atlas built in the background, together with its dynamic glyphs. They should not be accessed before the task
+	// is complete.
+	TUniquePtr<ImFontAtlas> PendingFontAtlas;
+	TUniquePtr<FImGuiDynamicGlyphs> PendingDynamicGlyphs;
+	FGraphEventRef PendingFontAtlasTask;
+	float PendingFontAtlasScale = -1.f;
+	int32 PendingDynamicGlyphsCapacity = 0;
+	TSharedPtr<TArray<uint8>, ESPMode::ThreadSafe> PendingGlyphFontData;
+
 	FImGuiModuleSettings& Settings;
 
+	// Scale used by contexts and the current font atlas, and the last scale requested by settings.
 	float DPIScale = -1.f;
+	float RequestedDPIScale = -1.f;
+	float UpdateFrequency = 0.f;
 	int32 FontResourcesReleaseCountdown = 0;
 };
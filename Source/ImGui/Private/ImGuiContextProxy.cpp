@@ -3,19 +3,51 @@
 #include "ImGuiContextProxy.h"
 
 #include "ImGuiDelegatesContainer.h"
+#include "ImGuiDelegatesProfiler.h"
 #include "ImGuiImplementation.h"
 #include "ImGuiInteroperability.h"
+#include "ImGuiModuleDebug.h"
 #include "Utilities/Arrays.h"
 #include "VersionCompatibility.h"
 
+#include <Async/ParallelFor.h>
 #include <GenericPlatform/GenericPlatformFile.h>
+#include <HAL/IConsoleManager.h>
 #include <Misc/Paths.h>
 
+#include <imgui_internal.h>
+
 
 static constexpr float DEFAULT_CANVAS_WIDTH = 3840.f;
 static constexpr float DEFAULT_CANVAS_HEIGHT = 2160.f;
 
 
+namespace CVars
+{
+	TAutoConsoleVariable<int> SkipIdleFrames(TEXT("ImGui.SkipIdleFrames"), 1,
+		TEXT("Whether contexts should skip updating draw data and rebuilding paint data in frames with the same output as\n")
+		TEXT("the previous frame and without input.\n")
+		TEXT("0: disabled\n")
+		TEXT("1: enabled (default)"),
+		ECVF_Default);
+}
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Idle Frames Skipped"), STAT_ImGui_IdleFramesSkipped, STATGROUP_ImGui);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Throttled Frames"), STAT_ImGui_ThrottledFrames, STATGROUP_ImGui);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Context Allocations"), STAT_ImGui_ContextAllocations, STATGROUP_ImGui);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Context System Allocations"), STAT_ImGui_ContextSystemAllocations, STATGROUP_ImGui);
+
+DECLARE_CYCLE_STAT(TEXT("Context Tick"), STAT_ImGui_ContextTick, STATGROUP_ImGui);
+DECLARE_CYCLE_STAT(TEXT("Context Begin Frame"), STAT_ImGui_ContextBeginFrame, STATGROUP_ImGui);
+DECLARE_CYCLE_STAT(TEXT("Context End Frame"), STAT_ImGui_ContextEndFrame, STATGROUP_ImGui);
+DECLARE_CYCLE_STAT(TEXT("Context Update Draw Data"), STAT_ImGui_ContextUpdateDrawData, STATGROUP_ImGui);
+DECLARE_CYCLE_STAT(TEXT("Module Debug"), STAT_ImGui_ModuleDebug, STATGROUP_ImGui);
+DECLARE_CYCLE_STAT(TEXT("World Early Debug"), STAT_ImGui_WorldEarlyDebug, STATGROUP_ImGui);
+DECLARE_CYCLE_STAT(TEXT("Multi-Context Early Debug"), STAT_ImGui_MultiContextEarlyDebug, STATGROUP_ImGui);
+DECLARE_CYCLE_STAT(TEXT("World Debug"), STAT_ImGui_WorldDebug, STATGROUP_ImGui);
+DECLARE_CYCLE_STAT(TEXT("Multi-Context Debug"), STAT_ImGui_MultiContextDebug, STATGROUP_ImGui);
+
+
 namespace
 {
 	FString GetSaveDirectory()
@@ -78,8 +110,28 @@ FImGuiContextProxy::FImGuiContextProxy(const FString& InName, int32 InContextInd
 	, ContextIndex(InContextIndex)
 	, IniFilename(TCHAR_TO_ANSI(*GetIniFile(InName)))
 {
-	// Create context.
-	Context = ImGui::CreateContext(InFontAtlas);
+	IMGUI_LLM_SCOPE(Context);
+
+#if STATS
+	// Per-context memory stat, so contexts can be compared in the stats group.
+	MemoryStatId = FDynamicStats::CreateMemoryStatId<FStatGroup_STATGROUP_ImGui>(FName(*FString::Printf(TEXT("Memory - %s"), *Name)));
+#endif
+
+	if (ContextIndex != Utilities::INVALID_CONTEXT_INDEX)
+	{
+		FImGuiDelegatesContainer& DelegatesContainer = FImGuiDelegatesContainer::Get();
+		WorldEarlyDebugEvent = &DelegatesContainer.OnWorldEarlyDebug(ContextIndex);
+		WorldDebugEvent = &DelegatesContainer.OnWorldDebug(ContextIndex);
+	}
+
+	// Create context, tracking allocations in its arena.
+	{
+		FImGuiContextArena::FScope ArenaScope(Arena);
+		Context = ImGui::CreateContext(InFontAtlas);
+	}
+
+	// Bind arena, so it is used whenever this context is current.
+	Arena.BindContext(Context);
 
 	// Set this context in ImGui for initialization (any allocations will be tracked in this context).
 	SetAsCurrent();
@@ -100,6 +152,9 @@ FImGuiContextProxy::FImGuiContextProxy(const FString& InName, int32 InContextInd
 	// Initialize key mapping, so context can correctly interpret input state.
 	ImGuiInterops::SetUnrealKeyMap(IO);
 
+	// Draw lists handle vertex offsets, so ImGui can output meshes with more than 64K vertices using 16-bit indices.
+	IO.BackendFlags |= ImGuiBackendFlags_RendererHasVtxOffset;
+
 	// Begin frame to complete context initialization (this is to avoid problems with other systems calling to ImGui
 	// during startup).
 	BeginFrame();
@@ -115,6 +170,8 @@ FImGuiContextProxy::~FImGuiContextProxy()
 
 		// Save context data and destroy.
 		ImGui::DestroyContext(Context);
+
+		Arena.UnbindContext();
 	}
 }
 
@@ -140,7 +197,9 @@ void FImGuiContextProxy::SetDPIScale(float Scale)
 
 void FImGuiContextProxy::DrawEarlyDebug()
 {
-	if (bIsFrameStarted && !bIsDrawEarlyDebugCalled)
+	UpdateThrottling();
+
+	if (bIsFrameStarted && !bIsDrawEarlyDebugCalled && !bIsThrottled)
 	{
 		bIsDrawEarlyDebugCalled = true;
 
@@ -154,7 +213,9 @@ void FImGuiContextProxy::DrawEarlyDebug()
 
 void FImGuiContextProxy::DrawDebug()
 {
-	if (bIsFrameStarted && !bIsDrawDebugCalled)
+	UpdateThrottling();
+
+	if (bIsFrameStarted && !bIsDrawDebugCalled && !bIsThrottled)
 	{
 		bIsDrawDebugCalled = true;
 
@@ -163,6 +224,14 @@ void FImGuiContextProxy::DrawDebug()
 
 		SetAsCurrent();
 
+		// Budget is only applied to the world and multi-context debug delegates, which are the main source of debug
+		// content. Early debug delegates are used to set up state for other functions, so they are never deferred.
+		bScheduleDebugDelegates = FImGuiDelegatesScheduler::IsEnabled();
+		if (bScheduleDebugDelegates)
+		{
+			DelegatesScheduler.BeginFrame();
+		}
+
 		// Delegates called in order specified in FImGuiDelegates.
 		BroadcastWorldDebug();
 		BroadcastMultiContextDebug();
@@ -174,18 +243,32 @@ void FImGuiContextProxy::Tick(float DeltaSeconds)
 	// Making sure that we tick only once per frame.
 	if (LastFrameNumber < GFrameNumber)
 	{
+		SCOPE_CYCLE_COUNTER(STAT_ImGui_ContextTick);
+		IMGUI_TRACE_CONTEXT_SCOPE("ImGui Context Tick", Name);
+
 		LastFrameNumber = GFrameNumber;
 
+		UpdateThrottling();
+
 		SetAsCurrent();
 
 		if (bIsFrameStarted)
 		{
-			// Make sure that draw events are called before the end of the frame.
-			DrawDebug();
+			if (bIsThrottled)
+			{
+				// Throttled frames are ended without rendering, so widgets keep presenting the output from the last
+				// update.
+				SkipFrame();
+			}
+			else
+			{
+				// Make sure that draw events are called before the end of the frame.
+				DrawDebug();
 
-			// Ending frame will produce render output that we capture and store for later use. This also puts context to
-			// state in which it does not allow to draw controls, so we want to immediately start a new frame.
-			EndFrame();
+				// Ending frame will produce render output that we capture and store for later use. This also puts context
+				// to state in which it does not allow to draw controls, so we want to immediately start a new frame.
+				EndFrame();
+			}
 		}
 
 		// Update context information (some data need to be collected before starting a new frame while some other data
@@ -201,15 +284,55 @@ void FImGuiContextProxy::Tick(float DeltaSeconds)
 	}
 }
 
+void FImGuiContextProxy::UpdateThrottling()
+{
+	// Decided once per frame, at the first debug event or tick, so debug delegates are either called in all events or
+	// in none of them. In parallel tick, this happens in the game thread before the context is updated. Debug events
+	// don't know the delta time of the coming tick, so the decision is based on time accumulated by frames started
+	// since the last update.
+	if (ThrottlingFrameNumber != GFrameNumber)
+	{
+		ThrottlingFrameNumber = GFrameNumber;
+
+		// Any input forces an update to keep interaction responsive. That includes input copied to the current frame
+		// and input waiting to be copied to the next one.
+		const float Frequency = GetUpdateFrequency();
+		bIsThrottled = Frequency > 0.f && AccumulatedDeltaTime < 1.f / Frequency && !bHasInputUpdates && !InputState.HasUpdates();
+	}
+}
+
 void FImGuiContextProxy::BeginFrame(float DeltaTime)
 {
 	if (!bIsFrameStarted)
 	{
+		SCOPE_CYCLE_COUNTER(STAT_ImGui_ContextBeginFrame);
+		IMGUI_TRACE_CONTEXT_SCOPE("ImGui Begin Frame", Name);
+
 		ImGuiIO& IO = ImGui::GetIO();
 		IO.DeltaTime = DeltaTime;
 
-		ImGuiInterops::CopyInput(IO, InputState);
-		InputState.ClearUpdateState();
+		// Throttling uses the same clock as ImGui, so it also works when ticks are driven with their own delta time
+		// (e.g. by Slate or tests).
+		AccumulatedDeltaTime += DeltaTime;
+
+		Arena.ResetFrameStats();
+		INC_DWORD_STAT_BY(STAT_ImGui_ContextAllocations, Arena.GetStats().NumFrameAllocations);
+		INC_DWORD_STAT_BY(STAT_ImGui_ContextSystemAllocations, Arena.GetStats().NumFrameSystemAllocations);
+
+		// After throttled frames, windows drawn only by debug delegates are not active, so input would not reach them.
+		// Input is kept in the input state, where it forces an update in which all windows are drawn, and it is copied
+		// to the frame after that one.
+		if (bIsThrottled)
+		{
+			bHasInputUpdates = false;
+		}
+		else
+		{
+			bHasInputUpdates = InputState.HasUpdates();
+
+			ImGuiInterops::CopyInput(IO, InputState);
+			InputState.ClearUpdateState();
+		}
 
 		IO.DisplaySize = { DisplaySize.X, DisplaySize.Y };
 
@@ -218,6 +341,7 @@ void FImGuiContextProxy::BeginFrame(float DeltaTime)
 		bIsFrameStarted = true;
 		bIsDrawEarlyDebugCalled = false;
 		bIsDrawDebugCalled = false;
+		bScheduleDebugDelegates = false;
 	}
 }
 
@@ -225,44 +349,181 @@ void FImGuiContextProxy::EndFrame()
 {
 	if (bIsFrameStarted)
 	{
+		SCOPE_CYCLE_COUNTER(STAT_ImGui_ContextEndFrame);
+		IMGUI_TRACE_CONTEXT_SCOPE("ImGui End Frame", Name);
+
+		// Windows of deferred functions need to be found before rendering, while their activity is still up to date.
+		RetainedWindowHashes.Reset();
+		if (bScheduleDebugDelegates)
+		{
+			DelegatesScheduler.GetRetainedWindows(RetainedWindowHashes);
+		}
+
 		// Prepare draw data (after this call we cannot draw to this context until we start a new frame).
 		ImGui::Render();
+		AccumulatedDeltaTime = 0.f;
+
+		ImDrawData* DrawData = ImGui::GetDrawData();
+
+		// Hash the content of draw lists, so we can find whether visible windows changed since the last update.
+		const int32 NumLists = DrawData ? DrawData->CmdListsCount : 0;
+		ListContentHashes.SetNumUninitialized(NumLists, false);
+		ParallelFor(NumLists, [this, DrawData](int32 Index)
+		{
+			ListContentHashes[Index] = FImGuiDrawList::CalculateContentHash(*DrawData->CmdLists[Index]);
+		});
 
-		// Update our draw data, so we can use them later during Slate rendering while ImGui is in the middle of the
-		// next frame.
-		UpdateDrawData(ImGui::GetDrawData());
+		// If there was no input and visible windows didn't change, then draw data and data painted from them are the
+		// same as in the last update and can be kept.
+		bIsIdle = CVars::SkipIdleFrames.GetValueOnAnyThread() > 0 && !bHasInputUpdates && RetainedWindowHashes.Num() == 0
+			&& HasSameDrawData();
+
+		if (bIsIdle)
+		{
+			NumSkippedIdleFrames++;
+			INC_DWORD_STAT(STAT_ImGui_IdleFramesSkipped);
+		}
+		else
+		{
+			// Update our draw data, so we can use them later during Slate rendering while ImGui is in the middle of the
+			// next frame.
+			UpdateDrawData(DrawData);
+			DrawDataVersion++;
+		}
+
+#if STATS
+		SET_MEMORY_STAT_FName(MemoryStatId.GetName(), GetMemoryStats().GetTotalBytes());
+#endif
+
+		bIsFrameStarted = false;
+	}
+}
+
+void FImGuiContextProxy::SkipFrame()
+{
+	if (bIsFrameStarted)
+	{
+		SCOPE_CYCLE_COUNTER(STAT_ImGui_ContextEndFrame);
+		IMGUI_TRACE_CONTEXT_SCOPE("ImGui Skip Frame", Name);
+
+		// Windows drawn only by debug delegates are not submitted in throttled frames. Keeping them marked as active
+		// stops ImGui from treating them as appearing again at the next update, which would reapply appearing
+		// conditions and focus them.
+		ImGuiContext& ImGuiState = *Context;
+		for (ImGuiWindow* Window : ImGuiState.Windows)
+		{
+			if (Window->LastFrameActive == ImGuiState.FrameCount - 1)
+			{
+				Window->LastFrameActive = ImGuiState.FrameCount;
+			}
+		}
+
+		// Finish the frame without preparing draw data. Functions called outside of debug delegates were processed in
+		// this frame, but they are presented only after the next update.
+		ImGui::EndFrame();
+
+		NumThrottledFrames++;
+		INC_DWORD_STAT(STAT_ImGui_ThrottledFrames);
 
 		bIsFrameStarted = false;
 	}
 }
 
+FImGuiContextProxy::FMemoryStats FImGuiContextProxy::GetMemoryStats() const
+{
+	FMemoryStats Stats;
+	Stats.ContextBytes = Arena.GetStats().ReservedBytes;
+	for (const FImGuiDrawList& DrawList : DrawLists)
+	{
+		Stats.DrawDataBytes += DrawList.GetAllocatedSize();
+	}
+	Stats.DrawDataBytes += DrawLists.GetAllocatedSize();
+	Stats.PaintBufferBytes = PaintBufferBytes;
+	return Stats;
+}
+
+bool FImGuiContextProxy::HasSameDrawData() const
+{
+	// Textures of draw commands are resolved when converting draw data, so changes in atlas placements also count.
+	const uint32 AtlasVersion = TextureManager ? TextureManager->GetAtlasVersion() : 0;
+	if (AtlasVersion != DrawDataAtlasVersion || ListContentHashes.Num() != DrawLists.Num())
+	{
+		return false;
+	}
+
+	for (int32 Index = 0; Index < DrawLists.Num(); Index++)
+	{
+		if (DrawLists[Index].GetContentHash() != ListContentHashes[Index])
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
 void FImGuiContextProxy::UpdateDrawData(ImDrawData* DrawData)
 {
-	if (DrawData && DrawData->CmdListsCount > 0)
+	SCOPE_CYCLE_COUNTER(STAT_ImGui_ContextUpdateDrawData);
+	IMGUI_TRACE_CONTEXT_SCOPE("ImGui Update Draw Data", Name);
+	IMGUI_LLM_SCOPE(DrawData);
+
+	// Lists of retained windows are kept from the last update and moved behind the new lists, so they are drawn on top.
+	// Swapping keeps the order of other lists, so their converted data can still be reused.
+	int32 NumReused = 0;
+	for (int32 Index = 0; Index < DrawLists.Num(); Index++)
+	{
+		if (!RetainedWindowHashes.Contains(DrawLists[Index].GetOwnerHash()))
+		{
+			if (Index != NumReused)
+			{
+				DrawLists.Swap(Index, NumReused);
+			}
+			NumReused++;
+		}
+	}
+
+	const int32 NumLists = DrawData ? DrawData->CmdListsCount : 0;
+	if (NumLists > NumReused)
 	{
-		DrawLists.SetNum(DrawData->CmdListsCount, false);
+		DrawLists.InsertDefaulted(NumReused, NumLists - NumReused);
+	}
+	else if (NumLists < NumReused)
+	{
+		DrawLists.RemoveAt(NumLists, NumReused - NumLists, false);
+	}
 
-		for (int Index = 0; Index < DrawData->CmdListsCount; Index++)
+	if (NumLists > 0)
+	{
+		// Transfer is cheap but it releases ImGui memory, so it is done serially in the context thread.
+		for (int Index = 0; Index < NumLists; Index++)
 		{
-			DrawLists[Index].TransferDrawData(*DrawData->CmdLists[Index]);
+			DrawLists[Index].TransferDrawData(*DrawData->CmdLists[Index], ListContentHashes[Index]);
 		}
+
+		// Convert lists to Slate format in parallel, so paint only needs to transform and submit prepared data.
+		ParallelFor(NumLists, [this](int32 Index)
+		{
+			DrawLists[Index].ConvertDrawData(TextureManager);
+		});
 	}
-	else
+
+	if (DrawLists.Num() == 0)
 	{
 		// If we are not rendering then this might be a good moment to empty the array.
 		DrawLists.Empty();
 	}
+
+	DrawDataAtlasVersion = TextureManager ? TextureManager->GetAtlasVersion() : 0;
 }
 
 void FImGuiContextProxy::BroadcastWorldEarlyDebug()
 {
-	if (ContextIndex != Utilities::INVALID_CONTEXT_INDEX)
+	if (WorldEarlyDebugEvent && WorldEarlyDebugEvent->IsBound())
 	{
-		FSimpleMulticastDelegate& WorldEarlyDebugEvent = FImGuiDelegatesContainer::Get().OnWorldEarlyDebug(ContextIndex);
-		if (WorldEarlyDebugEvent.IsBound())
-		{
-			WorldEarlyDebugEvent.Broadcast();
-		}
+		SCOPE_CYCLE_COUNTER(STAT_ImGui_WorldEarlyDebug);
+		IMGUI_TRACE_CONTEXT_SCOPE("ImGui World Early Debug", Name);
+		FImGuiDelegatesProfiler::Get().Broadcast(*WorldEarlyDebugEvent, TEXT("World Early Debug"));
 	}
 }
 
@@ -271,7 +532,9 @@ void FImGuiContextProxy::BroadcastMultiContextEarlyDebug()
 	FSimpleMulticastDelegate& MultiContextEarlyDebugEvent = FImGuiDelegatesContainer::Get().OnMultiContextEarlyDebug();
 	if (MultiContextEarlyDebugEvent.IsBound())
 	{
-		MultiContextEarlyDebugEvent.Broadcast();
+		SCOPE_CYCLE_COUNTER(STAT_ImGui_MultiContextEarlyDebug);
+		IMGUI_TRACE_CONTEXT_SCOPE("ImGui Multi-Context Early Debug", Name);
+		FImGuiDelegatesProfiler::Get().Broadcast(MultiContextEarlyDebugEvent, TEXT("Multi-Context Early Debug"));
 	}
 }
 
@@ -279,15 +542,22 @@ void FImGuiContextProxy::BroadcastWorldDebug()
 {
 	if (DrawEvent.IsBound())
 	{
+		SCOPE_CYCLE_COUNTER(STAT_ImGui_ModuleDebug);
+		IMGUI_TRACE_CONTEXT_SCOPE("ImGui Module Debug", Name);
 		DrawEvent.Broadcast();
 	}
 
-	if (ContextIndex != Utilities::INVALID_CONTEXT_INDEX)
+	if (WorldDebugEvent && WorldDebugEvent->IsBound())
 	{
-		FSimpleMulticastDelegate& WorldDebugEvent = FImGuiDelegatesContainer::Get().OnWorldDebug(ContextIndex);
-		if (WorldDebugEvent.IsBound())
+		SCOPE_CYCLE_COUNTER(STAT_ImGui_WorldDebug);
+		IMGUI_TRACE_CONTEXT_SCOPE("ImGui World Debug", Name);
+		if (bScheduleDebugDelegates)
+		{
+			DelegatesScheduler.Broadcast(*WorldDebugEvent, TEXT("World Debug"));
+		}
+		else
 		{
-			WorldDebugEvent.Broadcast();
+			FImGuiDelegatesProfiler::Get().Broadcast(*WorldDebugEvent, TEXT("World Debug"));
 		}
 	}
 }
@@ -297,6 +567,15 @@ void FImGuiContextProxy::BroadcastMultiContextDebug()
 	FSimpleMulticastDelegate& MultiContextDebugEvent = FImGuiDelegatesContainer::Get().OnMultiContextDebug();
 	if (MultiContextDebugEvent.IsBound())
 	{
-		MultiContextDebugEvent.Broadcast();
+		SCOPE_CYCLE_COUNTER(STAT_ImGui_MultiContextDebug);
+		IMGUI_TRACE_CONTEXT_SCOPE("ImGui Multi-Context Debug", Name);
+		if (bScheduleDebugDelegates)
+		{
+			DelegatesScheduler.Broadcast(MultiContextDebugEvent, TEXT("Multi-Context Debug"));
+		}
+		else
+		{
+			FImGuiDelegatesProfiler::Get().Broadcast(MultiContextDebugEvent, TEXT("Multi-Context Debug"));
+		}
 	}
 }
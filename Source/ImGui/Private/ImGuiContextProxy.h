@@ -2,11 +2,16 @@
 
 #pragma once
 
+#include "ImGuiContextArena.h"
+#include "ImGuiDelegatesScheduler.h"
 #include "ImGuiDrawData.h"
 #include "ImGuiInputState.h"
 #include "Utilities/WorldContextIndex.h"
 
+#include <Containers/Set.h>
 #include <GenericPlatform/ICursor.h>
+#include <Misc/Optional.h>
+#include <Stats/Stats.h>
 
 #include <imgui.h>
 
@@ -34,6 +39,37 @@ public:
 	// Get draw data from the last frame.
 	const TArray<FImGuiDrawList>& GetDrawData() const { return DrawLists; }
 
+	// Get the version of draw data, which changes whenever draw data are updated. Widgets can use it to reuse data that
+	// they painted from the same draw data.
+	uint32 GetDrawDataVersion() const { return DrawDataVersion; }
+
+	// Get memory arena used by this context.
+	const FImGuiContextArena& GetArena() const { return Arena; }
+
+	// Memory used by a context.
+	struct FMemoryStats
+	{
+		// Bytes reserved by the context arena for ImGui state and draw lists.
+		SIZE_T ContextBytes = 0;
+
+		// Bytes allocated for draw data converted to Slate format.
+		SIZE_T DrawDataBytes = 0;
+
+		// Bytes allocated by widgets for buffers used to paint this context.
+		SIZE_T PaintBufferBytes = 0;
+
+		SIZE_T GetTotalBytes() const { return ContextBytes + DrawDataBytes + PaintBufferBytes; }
+	};
+
+	// Get memory used by this context.
+	FMemoryStats GetMemoryStats() const;
+
+	// Set the number of bytes allocated by widgets for buffers used to paint this context.
+	void SetPaintBufferMemory(SIZE_T Bytes) { PaintBufferBytes = Bytes; }
+
+	// Set the texture manager used to resolve textures packed into atlas pages, when converting draw data.
+	void SetTextureManager(const FTextureManager* InTextureManager) { TextureManager = InTextureManager; }
+
 	// Get input state used by this context.
 	FImGuiInputState& GetInputState() { return InputState; }
 	const FImGuiInputState& GetInputState() const { return InputState; }
@@ -59,6 +95,23 @@ public:
 	// Set the DPI scale for this context.
 	void SetDPIScale(float Scale);
 
+	// Get the target frequency at which this context is updated (zero means every frame). If set, the override takes
+	// precedence over the frequency from settings.
+	float GetUpdateFrequency() const { return UpdateFrequencyOverride.Get(UpdateFrequency); }
+
+	// Set the target update frequency from settings.
+	void SetUpdateFrequency(float Frequency) { UpdateFrequency = Frequency; }
+
+	// Override the target update frequency for this context (zero means every frame).
+	void SetUpdateFrequencyOverride(float Frequency) { UpdateFrequencyOverride = Frequency; }
+
+	// Reset the update frequency override, so this context uses the frequency from settings.
+	void ResetUpdateFrequencyOverride() { UpdateFrequencyOverride.Reset(); }
+
+	// Get the number of frames in which this context didn't update because of the target update frequency. In those
+	// frames, debug delegates are not called and the ImGui frame is ended without rendering.
+	uint32 GetNumThrottledFrames() const { return NumThrottledFrames; }
+
 	// Whether this context has an active item (read once per frame during context update).
 	bool HasActiveItem() const { return bHasActiveItem; }
 
@@ -68,6 +121,16 @@ public:
 	// Cursor type desired by this context (updated once per frame during context update).
 	EMouseCursor::Type GetMouseCursor() const { return MouseCursor;  }
 
+	// Whether the last frame had no input and the same output as the previous one, in which case draw data from the
+	// previous frame are kept.
+	bool IsIdle() const { return bIsIdle; }
+
+	// Get the number of frames in which updating draw data was skipped because context was idle.
+	uint32 GetNumSkippedIdleFrames() const { return NumSkippedIdleFrames; }
+
+	// Get the number of debug delegate functions deferred in the last frame because of the frame budget.
+	uint32 GetNumDeferredDelegates() const { return DelegatesScheduler.GetNumDeferredFunctions(); }
+
 	// Internal draw event used to draw module's examples and debug widgets. Unlike the delegates container, it is not
 	// passed when the module is reloaded, so all objects that are unloaded with the module should register here.
 	FSimpleMulticastDelegate& OnDraw() { return DrawEvent; }
@@ -85,6 +148,13 @@ private:
 
 	void BeginFrame(float DeltaTime = 1.f / 60.f);
 	void EndFrame();
+	void SkipFrame();
+
+	// Decide whether the update in the current frame should be throttled.
+	void UpdateThrottling();
+
+	// Whether draw lists rendered in this frame have the same content as the current draw data.
+	bool HasSameDrawData() const;
 
 	void UpdateDrawData(ImDrawData* DrawData);
 
@@ -94,6 +164,9 @@ private:
 	void BroadcastWorldDebug();
 	void BroadcastMultiContextDebug();
 
+	// Arena needs to outlive the context and all the data allocated by it.
+	FImGuiContextArena Arena;
+
 	ImGuiContext* Context;
 
 	FVector2D DisplaySize = FVector2D::ZeroVector;
@@ -107,9 +180,39 @@ private:
 	bool bIsDrawEarlyDebugCalled = false;
 	bool bIsDrawDebugCalled = false;
 
+	bool bHasInputUpdates = false;
+	bool bIsIdle = false;
+	uint32 NumSkippedIdleFrames = 0;
+
+	float UpdateFrequency = 0.f;
+	TOptional<float> UpdateFrequencyOverride;
+	float AccumulatedDeltaTime = 0.f;
+	uint32 NumThrottledFrames = 0;
+	uint32 ThrottlingFrameNumber = 0;
+	bool bIsThrottled = false;
+
 	FImGuiInputState InputState;
 
 	TArray<FImGuiDrawList> DrawLists;
+	uint32 DrawDataVersion = 0;
+	uint32 DrawDataAtlasVersion = 0;
+
+	// Hashes of the content of draw lists rendered in the current frame.
+	TArray<uint64> ListContentHashes;
+
+	const FTextureManager* TextureManager = nullptr;
+
+	// Debug delegates scheduler and hashes of windows that are retained from the last update, because functions
+	// drawing them were deferred.
+	FImGuiDelegatesScheduler DelegatesScheduler;
+	TSet<uint64> RetainedWindowHashes;
+	bool bScheduleDebugDelegates = false;
+
+	SIZE_T PaintBufferBytes = 0;
+
+#if STATS
+	TStatId MemoryStatId;
+#endif
 
 	FString Name;
 	int32 ContextIndex = Utilities::INVALID_CONTEXT_INDEX;
@@ -118,5 +221,10 @@ private:
 
 	FSimpleMulticastDelegate DrawEvent;
 
+	// Delegates of world debug events for this context, cached to avoid lookups in every frame (null if this context
+	// is not associated with a world).
+	FSimpleMulticastDelegate* WorldEarlyDebugEvent = nullptr;
+	FSimpleMulticastDelegate* WorldDebugEvent = nullptr;
+
 	std::string IniFilename;
 };
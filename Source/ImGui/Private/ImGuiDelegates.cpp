@@ -35,3 +35,8 @@ FSimpleMulticastDelegate& FImGuiDelegates::OnMultiContextDebug()
 {
 	return FImGuiDelegatesContainer::Get().OnMultiContextDebug();
 }
+
+void FImGuiDelegates::SetDebugPriority(const FDelegateHandle& Handle, EImGuiDelegatePriority Priority)
+{
+	FImGuiDelegatesContainer::Get().SetDebugPriority(Handle, Priority);
+}
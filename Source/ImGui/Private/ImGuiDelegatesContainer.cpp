@@ -3,7 +3,9 @@
 #include "ImGuiDelegatesContainer.h"
 
 #include "ImGuiModule.h"
-#include "Utilities/WorldContextIndex.h"
+#include "Utilities/DelegateInvocationList.h"
+
+#include <Containers/Set.h>
 
 
 #if !WITH_EDITOR
@@ -60,7 +62,9 @@ FImGuiDelegatesContainerHandle& FImGuiDelegatesContainer::GetHandle()
 void FImGuiDelegatesContainer::MoveContainer(FImGuiDelegatesContainerHandle& OtherContainerHandle)
 {
 	// Only move data if pointer points to default instance, otherwise our data has already been moved and we only
-	// keep pointer to a more recent version.
+	// keep pointer to a more recent version. Per-context delegates are moved together with their allocations, so
+	// references cached by context proxies remain valid. This happens right after the other module is loaded, before
+	// it creates any contexts.
 	if (GetHandle().IsDefault())
 	{
 		OtherContainerHandle.Get() = MoveTemp(GetHandle().Get());
@@ -85,4 +89,69 @@ void FImGuiDelegatesContainer::Clear()
 	WorldDebugDelegates.Empty();
 	MultiContextEarlyDebugDelegate.Clear();
 	MultiContextDebugDelegate.Clear();
+	DebugPriorities.Empty();
+	NumDebugPrioritiesToPrune = MinDebugPrioritiesToPrune;
+}
+
+void FImGuiDelegatesContainer::SetDebugPriority(const FDelegateHandle& Handle, EImGuiDelegatePriority Priority)
+{
+	if (Priority != EImGuiDelegatePriority::Normal)
+	{
+		DebugPriorities.Add(Handle, Priority);
+
+		// Priorities are not removed when functions are unbound or delegates are cleared, so they are pruned against
+		// bound functions whenever their number doubles. This keeps the cost of pruning constant per added priority.
+		if (DebugPriorities.Num() >= NumDebugPrioritiesToPrune)
+		{
+			PruneDebugPriorities(Handle);
+			NumDebugPrioritiesToPrune = FMath::Max(2 * DebugPriorities.Num(), MinDebugPrioritiesToPrune);
+		}
+	}
+	else
+	{
+		DebugPriorities.Remove(Handle);
+	}
+}
+
+void FImGuiDelegatesContainer::PruneDebugPriorities(const FDelegateHandle& KeptHandle)
+{
+#if ENGINE_COMPATIBILITY_WITH_DELEGATE_INSTANCE_API
+	TSet<FDelegateHandle> BoundHandles;
+	BoundHandles.Add(KeptHandle);
+
+	auto AddBoundHandles = [&BoundHandles](const FSimpleMulticastDelegate& Delegate)
+	{
+		Utilities::FDelegateInvocationList InvocationList(Delegate);
+		for (int32 Index = 0; Index < InvocationList.NumFunctions(); Index++)
+		{
+			if (const IBaseDelegateInstance<void()>* Function = InvocationList.GetFunction(Index))
+			{
+				BoundHandles.Add(Function->GetHandle());
+			}
+		}
+	};
+
+	WorldEarlyDebugDelegates.ForEach(AddBoundHandles);
+	WorldDebugDelegates.ForEach(AddBoundHandles);
+	AddBoundHandles(MultiContextEarlyDebugDelegate);
+	AddBoundHandles(MultiContextDebugDelegate);
+
+	for (auto It = DebugPriorities.CreateIterator(); It; ++It)
+	{
+		if (!BoundHandles.Contains(It.Key()))
+		{
+			It.RemoveCurrent();
+		}
+	}
+#else
+	// Priorities are only used by the scheduler, which needs access to functions bound to delegates, so without it
+	// only the kept priority is needed.
+	const EImGuiDelegatePriority* KeptPriority = DebugPriorities.Find(KeptHandle);
+	const EImGuiDelegatePriority Priority = KeptPriority ? *KeptPriority : EImGuiDelegatePriority::Normal;
+	DebugPriorities.Reset();
+	if (Priority != EImGuiDelegatePriority::Normal)
+	{
+		DebugPriorities.Add(KeptHandle, Priority);
+	}
+#endif // ENGINE_COMPATIBILITY_WITH_DELEGATE_INSTANCE_API
 }
@@ -2,8 +2,12 @@
 
 #pragma once
 
+#include "ImGuiDelegates.h"
+#include "Utilities/WorldContextIndex.h"
+
 #include <Containers/Map.h>
 #include <Delegates/Delegate.h>
+#include <Templates/UniquePtr.h>
 
 
 #if WITH_EDITOR
@@ -28,7 +32,8 @@ public:
 	// Get delegate to ImGui world early debug event from known world instance.
 	FSimpleMulticastDelegate& OnWorldEarlyDebug(UWorld* World) { return OnWorldEarlyDebug(GetContextIndex(World)); }
 
-	// Get delegate to ImGui world early debug event from known context index.
+	// Get delegate to ImGui world early debug event from known context index. Returned reference stays valid for as
+	// long as the module is loaded, including after the container is moved during hot-reloading.
 	FSimpleMulticastDelegate& OnWorldEarlyDebug(int32 ContextIndex) { return WorldEarlyDebugDelegates.FindOrAdd(ContextIndex); }
 
 	// Get delegate to ImGui multi-context early debug event.
@@ -37,20 +42,83 @@ public:
 	// Get delegate to ImGui world debug event from known world instance.
 	FSimpleMulticastDelegate& OnWorldDebug(UWorld* World) { return OnWorldDebug(GetContextIndex(World)); }
 
-	// Get delegate to ImGui world debug event from known context index.
+	// Get delegate to ImGui world debug event from known context index. Returned reference stays valid for as long as
+	// the module is loaded, including after the container is moved during hot-reloading.
 	FSimpleMulticastDelegate& OnWorldDebug(int32 ContextIndex) { return WorldDebugDelegates.FindOrAdd(ContextIndex); }
 
 	// Get delegate to ImGui multi-context debug event.
 	FSimpleMulticastDelegate& OnMultiContextDebug() { return MultiContextDebugDelegate; }
 
+	// Get the priority of a function bound to debug delegates.
+	EImGuiDelegatePriority GetDebugPriority(const FDelegateHandle& Handle) const
+	{
+		const EImGuiDelegatePriority* Priority = DebugPriorities.Find(Handle);
+		return Priority ? *Priority : EImGuiDelegatePriority::Normal;
+	}
+
+	// Set the priority of a function bound to debug delegates. Priorities of functions that are no longer bound are
+	// pruned when the number of priorities doubles.
+	void SetDebugPriority(const FDelegateHandle& Handle, EImGuiDelegatePriority Priority);
+
 private:
 
+	// Dense table of delegates indexed by context indices, which are small integers starting from the invalid index.
+	// Delegates are allocated separately, so references to them stay valid when the table grows or is moved to another
+	// container.
+	struct FContextDelegates
+	{
+		FSimpleMulticastDelegate& FindOrAdd(int32 ContextIndex)
+		{
+			const int32 Slot = ContextIndex - Utilities::INVALID_CONTEXT_INDEX;
+			checkf(Slot >= 0, TEXT("Context index %d is out of the range of supported context indices."), ContextIndex);
+
+			if (Slot >= Delegates.Num())
+			{
+				Delegates.SetNum(Slot + 1);
+			}
+
+			if (!Delegates[Slot])
+			{
+				Delegates[Slot] = MakeUnique<FSimpleMulticastDelegate>();
+			}
+
+			return *Delegates[Slot];
+		}
+
+		void Empty() { Delegates.Empty(); }
+
+		template<typename FunctionType>
+		void ForEach(FunctionType Function) const
+		{
+			for (const TUniquePtr<FSimpleMulticastDelegate>& Delegate : Delegates)
+			{
+				if (Delegate)
+				{
+					Function(*Delegate);
+				}
+			}
+		}
+
+	private:
+
+		TArray<TUniquePtr<FSimpleMulticastDelegate>> Delegates;
+	};
+
 	int32 GetContextIndex(UWorld* World);
 
 	void Clear();
 
-	TMap<int32, FSimpleMulticastDelegate> WorldEarlyDebugDelegates;
-	TMap<int32, FSimpleMulticastDelegate> WorldDebugDelegates;
+	// Remove priorities of functions that are not bound to any debug delegate.
+	// @param KeptHandle - Handle whose priority is kept, even if its function is not bound yet
+	void PruneDebugPriorities(const FDelegateHandle& KeptHandle);
+
+	// Smallest number of priorities at which they are pruned.
+	static constexpr int32 MinDebugPrioritiesToPrune = 64;
+
+	FContextDelegates WorldEarlyDebugDelegates;
+	FContextDelegates WorldDebugDelegates;
 	FSimpleMulticastDelegate MultiContextEarlyDebugDelegate;
 	FSimpleMulticastDelegate MultiContextDebugDelegate;
+	TMap<FDelegateHandle, EImGuiDelegatePriority> DebugPriorities;
+	int32 NumDebugPrioritiesToPrune = MinDebugPrioritiesToPrune;
 };
@@ -0,0 +1,251 @@
+// Distributed under the MIT License (MIT) (see accompanying LICENSE file)
+
+#include "ImGuiDelegatesProfiler.h"
+
+#include "Utilities/DelegateInvocationList.h"
+#include "VersionCompatibility.h"
+
+#include <CoreGlobals.h>
+#include <HAL/IConsoleManager.h>
+#include <HAL/PlatformTime.h>
+#include <Misc/OutputDevice.h>
+#include <Misc/ScopeLock.h>
+#include <UObject/Class.h>
+#include <UObject/Object.h>
+
+#include <imgui.h>
+
+
+namespace CVars
+{
+	TAutoConsoleVariable<int> ProfileDelegates(TEXT("ImGui.ProfileDelegates"), 0,
+		TEXT("Whether functions bound to ImGui debug delegates should be profiled individually.\n")
+		TEXT("0: disabled (default)\n")
+		TEXT("1: enabled\n")
+		TEXT("2: enabled and profiler window is visible"),
+		ECVF_Default);
+}
+
+namespace
+{
+#if ENGINE_COMPATIBILITY_WITH_DELEGATE_INSTANCE_API
+	FString GetFunctionName(const IDelegateInstance& Instance, const TCHAR* EventName, uint64 Key)
+	{
+#if USE_DELEGATE_TRYGETBOUNDFUNCTIONNAME
+		const FName FunctionName = Instance.TryGetBoundFunctionName();
+		if (FunctionName != NAME_None)
+		{
+			return FunctionName.ToString();
+		}
+#endif
+
+		if (const UObject* Object = Instance.GetUObject())
+		{
+			return FString::Printf(TEXT("%s (%s)"), *Object->GetName(), *Object->GetClass()->GetName());
+		}
+
+		// Raw and lambda delegates can be only identified by their handles.
+		return FString::Printf(TEXT("%s #%llu"), EventName, Key);
+	}
+#endif // ENGINE_COMPATIBILITY_WITH_DELEGATE_INSTANCE_API
+
+	FORCEINLINE float GetMillisecondsSince(uint64 StartCycles)
+	{
+		return static_cast<float>(FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - StartCycles));
+	}
+}
+
+FImGuiDelegatesProfiler& FImGuiDelegatesProfiler::Get()
+{
+	static FImGuiDelegatesProfiler Profiler;
+	return Profiler;
+}
+
+void FImGuiDelegatesProfiler::Broadcast(const FSimpleMulticastDelegate& Delegate, const TCHAR* EventName)
+{
+	if (!IsEnabled())
+	{
+		Delegate.Broadcast();
+		return;
+	}
+
+#if ENGINE_COMPATIBILITY_WITH_DELEGATE_INSTANCE_API
+	Utilities::FDelegateInvocationList InvocationList(Delegate);
+	for (int32 Index = 0; Index < InvocationList.NumFunctions(); Index++)
+	{
+		const uint64 StartCycles = FPlatformTime::Cycles64();
+		if (InvocationList.CallFunction(Index))
+		{
+			const float Milliseconds = GetMillisecondsSince(StartCycles);
+
+			// Function might unbind itself, in which case its instance is already released.
+			if (const IBaseDelegateInstance<void()>* Function = InvocationList.GetFunction(Index))
+			{
+				RecordCall(*Function, EventName, Milliseconds);
+			}
+		}
+	}
+#else
+	// Invocation list is not accessible in this engine version, so the whole broadcast is attributed to the event.
+	const uint64 StartCycles = FPlatformTime::Cycles64();
+	Delegate.Broadcast();
+	const float Milliseconds = GetMillisecondsSince(StartCycles);
+
+	AddSample(reinterpret_cast<UPTRINT>(&Delegate), [&]() { return FString::Printf(TEXT("%s (all functions)"), EventName); },
+		EventName, Milliseconds);
+#endif // ENGINE_COMPATIBILITY_WITH_DELEGATE_INSTANCE_API
+}
+
+#if ENGINE_COMPATIBILITY_WITH_DELEGATE_INSTANCE_API
+void FImGuiDelegatesProfiler::RecordCall(const IDelegateInstance& Function, const TCHAR* EventName, float Milliseconds)
+{
+	if (IsEnabled())
+	{
+		const uint64 Key = GetTypeHash(Function.GetHandle());
+		AddSample(Key, [&]() { return GetFunctionName(Function, EventName, Key); }, EventName, Milliseconds);
+	}
+}
+#endif // ENGINE_COMPATIBILITY_WITH_DELEGATE_INSTANCE_API
+
+bool FImGuiDelegatesProfiler::IsEnabled() const
+{
+	return CVars::ProfileDelegates.GetValueOnAnyThread() > 0;
+}
+
+void FImGuiDelegatesProfiler::DrawWindow()
+{
+	if (CVars::ProfileDelegates.GetValueOnAnyThread() < 2)
+	{
+		return;
+	}
+
+	bool bIsOpen = true;
+	ImGui::SetNextWindowSize(ImVec2(720, 320), ImGuiCond_FirstUseEver);
+	if (ImGui::Begin("ImGui Delegates Profiler", &bIsOpen))
+	{
+		ImGui::Text("Times of the last %d calls of functions bound to debug delegates (ms).", NumSamples);
+		ImGui::SameLine();
+		if (ImGui::Button("Reset"))
+		{
+			Reset();
+		}
+
+		ImGui::Separator();
+
+		ImGui::Columns(6, "Delegates");
+		ImGui::TextUnformatted("Function"); ImGui::NextColumn();
+		ImGui::TextUnformatted("Event"); ImGui::NextColumn();
+		ImGui::TextUnformatted("Mean"); ImGui::NextColumn();
+		ImGui::TextUnformatted("P95"); ImGui::NextColumn();
+		ImGui::TextUnformatted("Max"); ImGui::NextColumn();
+		ImGui::TextUnformatted("Calls"); ImGui::NextColumn();
+		ImGui::Separator();
+
+		for (const FSummary& Summary : GetSummaries())
+		{
+			ImGui::TextUnformatted(TCHAR_TO_UTF8(*Summary.Name)); ImGui::NextColumn();
+			ImGui::TextUnformatted(TCHAR_TO_UTF8(Summary.EventName)); ImGui::NextColumn();
+			ImGui::Text("%.3f", Summary.Mean); ImGui::NextColumn();
+			ImGui::Text("%.3f", Summary.P95); ImGui::NextColumn();
+			ImGui::Text("%.3f", Summary.Max); ImGui::NextColumn();
+			ImGui::Text("%d", Summary.NumSamples); ImGui::NextColumn();
+		}
+
+		ImGui::Columns(1);
+	}
+	ImGui::End();
+
+	// Closing the window hides it in all contexts but profiling continues.
+	if (!bIsOpen)
+	{
+		CVars::ProfileDelegates->Set(1);
+	}
+}
+
+void FImGuiDelegatesProfiler::Dump(FOutputDevice& OutputDevice)
+{
+	const TArray<FSummary> Summaries = GetSummaries();
+
+	OutputDevice.Logf(TEXT("ImGui delegates profile (times of the last %d calls in ms):"), NumSamples);
+
+	for (const FSummary& Summary : Summaries)
+	{
+		OutputDevice.Logf(TEXT("  %s [%s]: Mean = %.3f, P95 = %.3f, Max = %.3f, Calls = %d"), *Summary.Name,
+			Summary.EventName, Summary.Mean, Summary.P95, Summary.Max, Summary.NumSamples);
+	}
+
+	if (Summaries.Num() == 0)
+	{
+		OutputDevice.Logf(TEXT("  No results. Profiling can be enabled with ImGui.ProfileDelegates."));
+	}
+}
+
+void FImGuiDelegatesProfiler::Reset()
+{
+	FScopeLock ScopeLock(&Lock);
+	Entries.Empty();
+}
+
+void FImGuiDelegatesProfiler::AddSample(uint64 Key, TFunctionRef<FString()> GetName, const TCHAR* EventName, float Milliseconds)
+{
+	FScopeLock ScopeLock(&Lock);
+
+	FEntry* Entry = Entries.Find(Key);
+	if (!Entry)
+	{
+		Entry = &Entries.Add(Key);
+		Entry->Name = GetName();
+		Entry->EventName = EventName;
+	}
+
+	Entry->Samples[Entry->NextSample] = Milliseconds;
+	Entry->NextSample = (Entry->NextSample + 1) % NumSamples;
+	Entry->NumRecorded = FMath::Min(Entry->NumRecorded + 1, NumSamples);
+	Entry->LastFrameNumber = GFrameNumber;
+}
+
+TArray<FImGuiDelegatesProfiler::FSummary> FImGuiDelegatesProfiler::GetSummaries()
+{
+	FScopeLock ScopeLock(&Lock);
+
+	TArray<FSummary> Summaries;
+	TArray<float, TInlineAllocator<NumSamples>> SortedSamples;
+
+	for (auto It = Entries.CreateIterator(); It; ++It)
+	{
+		const FEntry& Entry = It.Value();
+
+		// Remove functions that are no longer called (e.g. unbound or from destroyed worlds).
+		if (GFrameNumber - Entry.LastFrameNumber > ExpirationFrames)
+		{
+			It.RemoveCurrent();
+			continue;
+		}
+
+		// Until the history is full, samples are stored at the beginning of the buffer.
+		SortedSamples.Reset();
+		SortedSamples.Append(Entry.Samples, Entry.NumRecorded);
+		SortedSamples.Sort();
+
+		float Sum = 0.f;
+		for (float Sample : SortedSamples)
+		{
+			Sum += Sample;
+		}
+
+		const int32 Num = SortedSamples.Num();
+
+		FSummary Summary;
+		Summary.Name = Entry.Name;
+		Summary.EventName = Entry.EventName;
+		Summary.NumSamples = Num;
+		Summary.Mean = Sum / Num;
+		Summary.P95 = SortedSamples[FMath::Clamp(FMath::CeilToInt(Num * 0.95f) - 1, 0, Num - 1)];
+		Summary.Max = SortedSamples.Last();
+		Summaries.Add(MoveTemp(Summary));
+	}
+
+	Summaries.Sort([](const FSummary& A, const FSummary& B) { return A.Mean > B.Mean; });
+
+	return Summaries;
+}
@@ -0,0 +1,93 @@
+// Distributed under the MIT License (MIT) (see accompanying LICENSE file)
+
+#pragma once
+
+#include "VersionCompatibility.h"
+
+#include <Containers/Map.h>
+#include <Delegates/Delegate.h>
+#include <HAL/CriticalSection.h>
+#include <Templates/Function.h>
+
+
+class FOutputDevice;
+
+// Opt-in profiler measuring the cost of individual functions bound to ImGui debug delegates. When enabled, broadcasts
+// call bound functions one by one and time each invocation, so expensive panels can be attributed to their owners.
+// Results can be seen in a built-in ImGui window or printed with a console command.
+class FImGuiDelegatesProfiler
+{
+public:
+
+	// Get the profiler instance.
+	static FImGuiDelegatesProfiler& Get();
+
+	// Whether profiling is enabled.
+	bool IsEnabled() const;
+
+	// Broadcast a debug delegate. If profiling is enabled, every bound function is timed separately.
+	// @param Delegate - Delegate to broadcast
+	// @param EventName - Name of the debug event, used to describe functions that cannot be identified otherwise
+	void Broadcast(const FSimpleMulticastDelegate& Delegate, const TCHAR* EventName);
+
+#if ENGINE_COMPATIBILITY_WITH_DELEGATE_INSTANCE_API
+	// Record the time of a function called outside of the profiler broadcast (e.g. by the delegates scheduler).
+	// Ignored if profiling is disabled.
+	// @param Function - Delegate instance of the called function
+	// @param EventName - Name of the debug event
+	// @param Milliseconds - Invocation time
+	void RecordCall(const IDelegateInstance& Function, const TCHAR* EventName, float Milliseconds);
+#endif
+
+	// Draw profiler window in the current ImGui context, if it is enabled.
+	void DrawWindow();
+
+	// Print profiling results.
+	void Dump(FOutputDevice& OutputDevice);
+
+	// Clear all profiling results.
+	void Reset();
+
+private:
+
+	// Number of samples kept for every profiled function.
+	static constexpr int32 NumSamples = 128;
+
+	// Number of frames after which functions that are no longer called are removed from results.
+	static constexpr uint32 ExpirationFrames = 600;
+
+	// Rolling history of invocation times of a single bound function.
+	struct FEntry
+	{
+		FString Name;
+		const TCHAR* EventName = nullptr;
+		float Samples[NumSamples];
+		int32 NumRecorded = 0;
+		int32 NextSample = 0;
+		uint32 LastFrameNumber = 0;
+	};
+
+	// Summary of recorded invocation times (in milliseconds).
+	struct FSummary
+	{
+		FString Name;
+		const TCHAR* EventName = nullptr;
+		int32 NumSamples = 0;
+		float Mean = 0.f;
+		float P95 = 0.f;
+		float Max = 0.f;
+	};
+
+	// Add a sample to the entry with the given key, creating it if necessary.
+	// @param Key - Key identifying the profiled function (delegate handle or delegate address, if not available)
+	// @param GetName - Function returning the name of a new entry
+	// @param EventName - Name of the debug event
+	// @param Milliseconds - Invocation time
+	void AddSample(uint64 Key, TFunctionRef<FString()> GetName, const TCHAR* EventName, float Milliseconds);
+
+	// Get summaries of all recent entries sorted from the most expensive ones, removing expired entries.
+	TArray<FSummary> GetSummaries();
+
+	TMap<uint64, FEntry> Entries;
+	FCriticalSection Lock;
+};
@@ -0,0 +1,166 @@
+// Distributed under the MIT License (MIT) (see accompanying LICENSE file)
+
+#include "ImGuiDelegatesScheduler.h"
+
+#include "ImGuiDelegatesContainer.h"
+#include "ImGuiDelegatesProfiler.h"
+#include "ImGuiModuleDebug.h"
+#include "Utilities/DelegateInvocationList.h"
+#include "VersionCompatibility.h"
+
+#include <CoreGlobals.h>
+#include <Hash/CityHash.h>
+#include <HAL/IConsoleManager.h>
+#include <HAL/PlatformTime.h>
+
+#include <imgui_internal.h>
+
+
+namespace CVars
+{
+	TAutoConsoleVariable<float> DebugFrameBudget(TEXT("ImGui.DebugFrameBudget"), 0.f,
+		TEXT("Time budget in milliseconds for functions bound to world and multi-context debug delegates, per context\n")
+		TEXT("and frame. Functions that don't fit in the budget are deferred to the next frame and their windows keep\n")
+		TEXT("showing the previous output. Zero disables the budget (default)."),
+		ECVF_Default);
+}
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Deferred Delegate Functions"), STAT_ImGui_DeferredDelegateFunctions, STATGROUP_ImGui);
+
+bool FImGuiDelegatesScheduler::IsEnabled()
+{
+#if ENGINE_COMPATIBILITY_WITH_DELEGATE_INSTANCE_API
+	return CVars::DebugFrameBudget.GetValueOnAnyThread() > 0.f;
+#else
+	return false;
+#endif
+}
+
+void FImGuiDelegatesScheduler::BeginFrame()
+{
+	FrameMilliseconds = 0.0;
+	FrameNumber = GFrameNumber;
+	DeferredFunctions.Reset();
+
+	// Remove states of functions that are no longer bound.
+	for (auto It = Functions.CreateIterator(); It; ++It)
+	{
+		if (FrameNumber - It.Value().LastScheduledFrameNumber > ExpirationFrames)
+		{
+			It.RemoveCurrent();
+		}
+	}
+}
+
+void FImGuiDelegatesScheduler::Broadcast(const FSimpleMulticastDelegate& Delegate, const TCHAR* EventName)
+{
+#if ENGINE_COMPATIBILITY_WITH_DELEGATE_INSTANCE_API
+	struct FScheduledCall
+	{
+		int32 Index;
+		FDelegateHandle Handle;
+		EImGuiDelegatePriority Priority;
+		uint32 LastCallFrameNumber;
+	};
+
+	const double Budget = CVars::DebugFrameBudget.GetValueOnAnyThread();
+	const FImGuiDelegatesContainer& Container = FImGuiDelegatesContainer::Get();
+
+	Utilities::FDelegateInvocationList InvocationList(Delegate);
+
+	TArray<FScheduledCall, TInlineAllocator<16>> Calls;
+	for (int32 Index = 0; Index < InvocationList.NumFunctions(); Index++)
+	{
+		if (const IBaseDelegateInstance<void()>* Function = InvocationList.GetFunction(Index))
+		{
+			const FDelegateHandle Handle = Function->GetHandle();
+			FFunctionState& State = Functions.FindOrAdd(Handle);
+			State.LastScheduledFrameNumber = FrameNumber;
+			Calls.Add({ Index, Handle, Container.GetDebugPriority(Handle), State.LastCallFrameNumber });
+		}
+	}
+
+	// Higher priorities go first, then functions that waited the longest. Stable sort keeps the broadcast order for
+	// functions that are otherwise equal.
+	Calls.StableSort([](const FScheduledCall& A, const FScheduledCall& B)
+	{
+		return A.Priority != B.Priority ? A.Priority > B.Priority : A.LastCallFrameNumber < B.LastCallFrameNumber;
+	});
+
+	const ImGuiContext& Context = *ImGui::GetCurrentContext();
+	TArray<ImGuiID, TInlineAllocator<32>> ActiveWindows;
+
+	bool bHasCalledFunction = false;
+	for (const FScheduledCall& Call : Calls)
+	{
+		if (bHasCalledFunction && Call.Priority != EImGuiDelegatePriority::Critical && FrameMilliseconds >= Budget)
+		{
+			DeferredFunctions.AddUnique(Call.Handle);
+			NumDeferredCalls++;
+			INC_DWORD_STAT(STAT_ImGui_DeferredDelegateFunctions);
+			continue;
+		}
+
+		// Remember windows that are already active, so we can find windows drawn by this function. Window order can
+		// change when windows are drawn, so we need to use identifiers.
+		ActiveWindows.Reset();
+		for (const ImGuiWindow* Window : Context.Windows)
+		{
+			if (Window->LastFrameActive == Context.FrameCount)
+			{
+				ActiveWindows.Add(Window->ID);
+			}
+		}
+
+		const uint64 StartCycles = FPlatformTime::Cycles64();
+		const bool bCalled = InvocationList.CallFunction(Call.Index);
+		const float Milliseconds = static_cast<float>(FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - StartCycles));
+
+		if (bCalled)
+		{
+			bHasCalledFunction = true;
+			FrameMilliseconds += Milliseconds;
+
+			// Function might unbind itself, in which case its instance is already released.
+			if (const IBaseDelegateInstance<void()>* Function = InvocationList.GetFunction(Call.Index))
+			{
+				FImGuiDelegatesProfiler::Get().RecordCall(*Function, EventName, Milliseconds);
+			}
+
+			FFunctionState& State = Functions.FindChecked(Call.Handle);
+			State.LastCallFrameNumber = FrameNumber;
+			State.Windows.Reset();
+			for (const ImGuiWindow* Window : Context.Windows)
+			{
+				if (Window->LastFrameActive == Context.FrameCount && !ActiveWindows.Contains(Window->ID))
+				{
+					State.Windows.Add(Window->ID);
+				}
+			}
+		}
+	}
+#else
+	Delegate.Broadcast();
+#endif // ENGINE_COMPATIBILITY_WITH_DELEGATE_INSTANCE_API
+}
+
+void FImGuiDelegatesScheduler::GetRetainedWindows(TSet<uint64>& OutWindowHashes) const
+{
+	const ImGuiContext& Context = *ImGui::GetCurrentContext();
+
+	for (const FDelegateHandle& Handle : DeferredFunctions)
+	{
+		if (const FFunctionState* State = Functions.Find(Handle))
+		{
+			for (ImGuiID WindowID : State->Windows)
+			{
+				// Windows drawn in this frame by other functions are presented with their new content.
+				const ImGuiWindow* Window = ImGui::FindWindowByID(WindowID);
+				if (Window && Window->LastFrameActive != Context.FrameCount)
+				{
+					OutWindowHashes.Add(CityHash64(Window->Name, FCStringAnsi::Strlen(Window->Name)));
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,65 @@
+// Distributed under the MIT License (MIT) (see accompanying LICENSE file)
+
+#pragma once
+
+#include "ImGuiDelegates.h"
+
+#include <Containers/Map.h>
+#include <Containers/Set.h>
+
+#include <imgui.h>
+
+
+// Schedules functions bound to debug delegates of a single context within a frame time budget. When the budget is
+// exceeded, remaining functions are deferred to the next frame. Functions are called in the order of their priorities
+// and then starting from the ones that waited the longest, so deferred functions are called in round-robin order.
+// Windows drawn by deferred functions can be retained, so their previous output is still presented.
+class FImGuiDelegatesScheduler
+{
+public:
+
+	// Whether scheduling is enabled (it requires a non-zero budget and engine support for calling functions one by one).
+	static bool IsEnabled();
+
+	// Start scheduling a new frame. Should be called before broadcasting debug delegates.
+	void BeginFrame();
+
+	// Broadcast a debug delegate, deferring functions if the frame budget is exceeded. At least one function is called
+	// in each broadcast, so every function is eventually called. ImGui context should be set as current.
+	// @param Delegate - Delegate to broadcast
+	// @param EventName - Name of the debug event, used by the profiler
+	void Broadcast(const FSimpleMulticastDelegate& Delegate, const TCHAR* EventName);
+
+	// Get hashes of names of windows drawn by functions deferred in this frame (and not drawn by any other function).
+	// ImGui context should be set as current.
+	// @param OutWindowHashes - Set filled with hashes of window names
+	void GetRetainedWindows(TSet<uint64>& OutWindowHashes) const;
+
+	// Get the number of functions deferred in the current or the last frame.
+	uint32 GetNumDeferredFunctions() const { return DeferredFunctions.Num(); }
+
+	// Get the total number of deferred function calls.
+	uint32 GetNumDeferredCalls() const { return NumDeferredCalls; }
+
+private:
+
+	// Scheduling state of a bound function.
+	struct FFunctionState
+	{
+		// Windows that became active when the function was called the last time.
+		TArray<ImGuiID, TInlineAllocator<2>> Windows;
+
+		uint32 LastCallFrameNumber = 0;
+		uint32 LastScheduledFrameNumber = 0;
+	};
+
+	// Number of frames after which states of functions that are no longer scheduled are removed.
+	static constexpr uint32 ExpirationFrames = 600;
+
+	TMap<FDelegateHandle, FFunctionState> Functions;
+	TArray<FDelegateHandle> DeferredFunctions;
+
+	double FrameMilliseconds = 0.0;
+	uint32 FrameNumber = 0;
+	uint32 NumDeferredCalls = 0;
+};
@@ -2,55 +2,161 @@
 
 #include "ImGuiDrawData.h"
 
+#include "ImGuiModuleDebug.h"
+#include "ImGuiVertexConversion.h"
+
+#include <Containers/BitArray.h>
+#include <Hash/CityHash.h>
+#include <HAL/IConsoleManager.h>
+
+
+namespace CVars
+{
+	TAutoConsoleVariable<int> ReuseUnchangedDrawLists(TEXT("ImGui.DrawData.ReuseUnchangedLists"), 1,
+		TEXT("Whether draw lists with the same content as in the previous frame should reuse converted data.\n")
+		TEXT("0: disabled\n")
+		TEXT("1: enabled (default)"),
+		ECVF_Default);
+}
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Draw List Conversion Hits"), STAT_ImGui_DrawListConversionHits, STATGROUP_ImGui);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Draw List Conversion Misses"), STAT_ImGui_DrawListConversionMisses, STATGROUP_ImGui);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Draw List Transform Hits"), STAT_ImGui_DrawListTransformHits, STATGROUP_ImGui);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Draw List Transform Misses"), STAT_ImGui_DrawListTransformMisses, STATGROUP_ImGui);
+
+namespace
+{
+	// Copy indices subtracting from them a rebase value. ImDrawIdx and SlateIndex can be different types (SlateIndex can
+	// have different size on different platforms), so indices are converted one by one. Rebase values are minimum
+	// indices of commands, so they are rarely zero and a block copy for matching types wouldn't be used in practice.
+	template<typename DstIndexType, typename SrcIndexType>
+	FORCEINLINE void CopyIndices(DstIndexType* RESTRICT Dst, const SrcIndexType* RESTRICT Src, uint32 Num, uint32 Rebase)
+	{
+		for (uint32 i = 0; i < Num; i++)
+		{
+			Dst[i] = static_cast<DstIndexType>(Src[i] - Rebase);
+		}
+	}
+
+	// Map texture coordinates of vertices referenced by indices to a sub-rectangle of an atlas page. Vertices that were
+	// already remapped are skipped, so vertices referenced by many indices are remapped only once.
+	FORCEINLINE void RemapTexCoords(FSlateVertex* RESTRICT Vertices, const ImDrawIdx* RESTRICT Indices, uint32 NumIndices,
+		uint32 VertexOffset, TBitArray<>& RemappedVertices, const FVector2D& Offset, const FVector2D& Scale)
+	{
+		for (uint32 i = 0; i < NumIndices; i++)
+		{
+			const uint32 VertexIndex = VertexOffset + Indices[i];
+			if (!RemappedVertices[VertexIndex])
+			{
+				RemappedVertices[VertexIndex] = true;
+				Vertices[VertexIndex].TexCoords[0] = Offset.X + Vertices[VertexIndex].TexCoords[0] * Scale.X;
+				Vertices[VertexIndex].TexCoords[1] = Offset.Y + Vertices[VertexIndex].TexCoords[1] * Scale.Y;
+			}
+		}
+	}
+
+	// Copy Slate indices adding to them a shift value.
+	FORCEINLINE void ShiftIndices(SlateIndex* RESTRICT Dst, const SlateIndex* RESTRICT Src, uint32 Num, uint32 Shift)
+	{
+		if (Shift == 0)
+		{
+			FMemory::Memcpy(Dst, Src, Num * sizeof(SlateIndex));
+		}
+		else
+		{
+			for (uint32 i = 0; i < Num; i++)
+			{
+				Dst[i] = Src[i] + Shift;
+			}
+		}
+	}
+}
 
 #if ENGINE_COMPATIBILITY_LEGACY_CLIPPING_API
-void FImGuiDrawList::CopyVertexData(TArray<FSlateVertex>& OutVertexBuffer, const FTransform2D& Transform, const FSlateRotatedRect& VertexClippingRect) const
+void FImGuiDrawList::CopyVertexData(TArray<FSlateVertex>& OutVertexBuffer, const FTransform2D& Transform, const FSlateRotatedRect& VertexClippingRect, const FImGuiDrawCommand& Command) const
 #else
-void FImGuiDrawList::CopyVertexData(TArray<FSlateVertex>& OutVertexBuffer, const FTransform2D& Transform) const
+void FImGuiDrawList::CopyVertexData(TArray<FSlateVertex>& OutVertexBuffer, const FTransform2D& Transform, const FImGuiDrawCommand& Command) const
 #endif // ENGINE_COMPATIBILITY_LEGACY_CLIPPING_API
 {
-	// Reset and reserve space in destination buffer.
-	OutVertexBuffer.SetNumUninitialized(ImGuiVertexBuffer.Size, false);
+	UpdateTransformedVertices(Transform);
 
-	// Transform and copy vertex data.
-	for (int Idx = 0; Idx < ImGuiVertexBuffer.Size; Idx++)
-	{
-		const ImDrawVert& ImGuiVertex = ImGuiVertexBuffer[Idx];
-		FSlateVertex& SlateVertex = OutVertexBuffer[Idx];
+	// Reset and reserve space in destination buffer.
+	OutVertexBuffer.SetNumUninitialized(Command.NumVertices, false);
 
-		// Final UV is calculated in shader as XY * ZW, so we need set all components.
-		SlateVertex.TexCoords[0] = ImGuiVertex.uv.x;
-		SlateVertex.TexCoords[1] = ImGuiVertex.uv.y;
-		SlateVertex.TexCoords[2] = SlateVertex.TexCoords[3] = 1.f;
+	// Copy vertices that were already transformed to the target space.
+	FMemory::Memcpy(OutVertexBuffer.GetData(), TransformedVertexBuffer.GetData() + Command.VertexOffset, Command.NumVertices * sizeof(FSlateVertex));
 
 #if ENGINE_COMPATIBILITY_LEGACY_CLIPPING_API
-		const FVector2D VertexPosition = Transform.TransformPoint(ImGuiInterops::ToVector2D(ImGuiVertex.pos));
-		SlateVertex.Position[0] = VertexPosition.X;
-		SlateVertex.Position[1] = VertexPosition.Y;
+	for (FSlateVertex& SlateVertex : OutVertexBuffer)
+	{
 		SlateVertex.ClipRect = VertexClippingRect;
-#else
-		SlateVertex.Position = Transform.TransformPoint(ImGuiInterops::ToVector2D(ImGuiVertex.pos));
+	}
 #endif // ENGINE_COMPATIBILITY_LEGACY_CLIPPING_API
+}
+
+void FImGuiDrawList::CopyIndexData(TArray<SlateIndex>& OutIndexBuffer, const FImGuiDrawCommand& Command) const
+{
+	// Reset buffer.
+	OutIndexBuffer.SetNumUninitialized(Command.NumElements, false);
 
-		// Unpack ImU32 color.
-		SlateVertex.Color = ImGuiInterops::UnpackImU32Color(ImGuiVertex.col);
+	// Copy elements that were already rebased during conversion. Indices of merged commands are shifted to address
+	// their vertices inside of the merged vertex range.
+	SlateIndex* Dst = OutIndexBuffer.GetData();
+	for (int CommandNb = Command.FirstCommandNb; CommandNb < Command.FirstCommandNb + Command.NumCommands; CommandNb++)
+	{
+		const ImDrawCmd& ImGuiCommand = ImGuiCommandBuffer[CommandNb];
+		if (ImGuiCommand.ElemCount > 0)
+		{
+			const uint32 Shift = CommandVertexRanges[CommandNb].Offset - Command.VertexOffset;
+			ShiftIndices(Dst, SlateIndexBuffer.GetData() + ImGuiCommand.IdxOffset, ImGuiCommand.ElemCount, Shift);
+			Dst += ImGuiCommand.ElemCount;
+		}
 	}
 }
 
-void FImGuiDrawList::CopyIndexData(TArray<SlateIndex>& OutIndexBuffer, const int32 StartIndex, const int32 NumElements) const
+bool FImGuiDrawList::CanMergeCommands(const FImGuiDrawCommand& Command, const FImGuiDrawCommand& NextCommand)
 {
-	// Reset buffer.
-	OutIndexBuffer.SetNumUninitialized(NumElements, false);
+	// Commands without elements don't reference any vertices.
+	if (Command.NumElements == 0 || NextCommand.NumElements == 0)
+	{
+		return true;
+	}
+
+	// Commands with different VtxOffset can reference distant ranges of vertices, so the merged range also includes all
+	// vertices between them.
+	const uint64 VertexStart = FMath::Min(Command.VertexOffset, NextCommand.VertexOffset);
+	const uint64 VertexEnd = FMath::Max(Command.VertexOffset + Command.NumVertices, NextCommand.VertexOffset + NextCommand.NumVertices);
+	return VertexEnd - VertexStart <= static_cast<uint64>(TNumericLimits<SlateIndex>::Max()) + 1;
+}
 
-	// Copy elements (slow copy because of different sizes of ImDrawIdx and SlateIndex and because SlateIndex can
-	// have different size on different platforms).
-	for (int i = 0; i < NumElements; i++)
+void FImGuiDrawList::MergeCommands(FImGuiDrawCommand& Command, const FImGuiDrawCommand& NextCommand)
+{
+	checkf(Command.FirstCommandNb + Command.NumCommands == NextCommand.FirstCommandNb,
+		TEXT("Only consecutive draw commands can be merged."));
+	checkf(CanMergeCommands(Command, NextCommand), TEXT("Merged vertex range would exceed the range of Slate indices."));
+
+	// Commands without elements don't reference any vertices.
+	if (NextCommand.NumElements > 0)
 	{
-		OutIndexBuffer[i] = ImGuiIndexBuffer[StartIndex + i];
+		if (Command.NumElements > 0)
+		{
+			const uint32 VertexEnd = FMath::Max(Command.VertexOffset + Command.NumVertices, NextCommand.VertexOffset + NextCommand.NumVertices);
+			Command.VertexOffset = FMath::Min(Command.VertexOffset, NextCommand.VertexOffset);
+			Command.NumVertices = VertexEnd - Command.VertexOffset;
+		}
+		else
+		{
+			Command.IndexOffset = NextCommand.IndexOffset;
+			Command.VertexOffset = NextCommand.VertexOffset;
+			Command.NumVertices = NextCommand.NumVertices;
+		}
 	}
+
+	Command.NumElements += NextCommand.NumElements;
+	Command.NumCommands += NextCommand.NumCommands;
 }
 
-void FImGuiDrawList::TransferDrawData(ImDrawList& Src)
+void FImGuiDrawList::TransferDrawData(ImDrawList& Src, uint64 InContentHash)
 {
 	// Move data from source to this list.
 	Src.CmdBuffer.swap(ImGuiCommandBuffer);
@@ -60,4 +166,147 @@ void FImGuiDrawList::TransferDrawData(ImDrawList& Src)
 	// ImGui seems to clear draw lists in every frame, but since source list can contain pointers to buffers that
 	// we just swapped, it is better to clear explicitly here.
 	Src.Clear();
+
+	// Name of the window that owns this list, used to find lists of retained windows.
+	OwnerHash = Src._OwnerName ? CityHash64(Src._OwnerName, FCStringAnsi::Strlen(Src._OwnerName)) : 0;
+	ContentHash = InContentHash;
+}
+
+void FImGuiDrawList::ConvertDrawData(const FTextureManager* TextureManager)
+{
+	IMGUI_LLM_SCOPE(DrawData);
+
+	// Many windows don't change between frames, so if this list has the same content as in the previous frame, we can
+	// keep data converted back then.
+	const uint32 AtlasVersion = TextureManager ? TextureManager->GetAtlasVersion() : 0;
+	const uint64 NewFingerprint = CityHash64WithSeed(reinterpret_cast<const char*>(&AtlasVersion), sizeof(AtlasVersion), ContentHash);
+	if (bHasConvertedData && NewFingerprint == Fingerprint && CVars::ReuseUnchangedDrawLists.GetValueOnAnyThread() > 0)
+	{
+		INC_DWORD_STAT(STAT_ImGui_DrawListConversionHits);
+		return;
+	}
+
+	INC_DWORD_STAT(STAT_ImGui_DrawListConversionMisses);
+
+	Fingerprint = NewFingerprint;
+	bHasConvertedData = true;
+	bHasTransformedData = false;
+
+	UpdateVertexRanges();
+
+	// Convert vertices to Slate format. Only positions depend on the widget geometry, so they are left in ImGui space
+	// and transformed when copying data for a draw command.
+	SlateVertexBuffer.SetNumUninitialized(ImGuiVertexBuffer.Size, false);
+	VertexBounds = ImGuiVertexConversion::ConvertVertices(ImGuiVertexBuffer.Data, SlateVertexBuffer.GetData(), ImGuiVertexBuffer.Size);
+
+	// Convert indices, rebasing them to match vertices copied for each command.
+	SlateIndexBuffer.SetNumUninitialized(ImGuiIndexBuffer.Size, false);
+	for (int CommandNb = 0; CommandNb < ImGuiCommandBuffer.Size; CommandNb++)
+	{
+		const ImDrawCmd& ImGuiCommand = ImGuiCommandBuffer[CommandNb];
+		CopyIndices(SlateIndexBuffer.GetData() + ImGuiCommand.IdxOffset, ImGuiIndexBuffer.Data + ImGuiCommand.IdxOffset,
+			ImGuiCommand.ElemCount, CommandVertexRanges[CommandNb].IndexRebase);
+	}
+
+	ResolveCommandTextures(TextureManager);
+}
+
+void FImGuiDrawList::ResolveCommandTextures(const FTextureManager* TextureManager)
+{
+	CommandTextures.SetNumUninitialized(ImGuiCommandBuffer.Size, false);
+
+	// Channels (used e.g. by columns) share one vertex buffer, so the vertex range of a command can also contain
+	// vertices of commands from other channels. Only vertices referenced by indices of a command are remapped.
+	TBitArray<> RemappedVertices;
+
+	for (int CommandNb = 0; CommandNb < ImGuiCommandBuffer.Size; CommandNb++)
+	{
+		const ImDrawCmd& ImGuiCommand = ImGuiCommandBuffer[CommandNb];
+		TextureIndex& Texture = CommandTextures[CommandNb];
+		Texture = ImGuiInterops::ToTextureIndex(ImGuiCommand.TextureId);
+
+		FVector2D UVOffset, UVScale;
+		if (TextureManager && TextureManager->GetAtlasPlacement(Texture, Texture, UVOffset, UVScale))
+		{
+			if (RemappedVertices.Num() == 0)
+			{
+				RemappedVertices.Init(false, SlateVertexBuffer.Num());
+			}
+
+			RemapTexCoords(SlateVertexBuffer.GetData(), ImGuiIndexBuffer.Data + ImGuiCommand.IdxOffset, ImGuiCommand.ElemCount,
+				ImGuiCommand.VtxOffset, RemappedVertices, UVOffset, UVScale);
+		}
+	}
+}
+
+uint64 FImGuiDrawList::CalculateContentHash(const ImDrawList& List)
+{
+	// Name of the window that owns the list, to make sure that hashes of lists from different windows differ.
+	uint64 Hash = List._OwnerName ? CityHash64(List._OwnerName, FCStringAnsi::Strlen(List._OwnerName)) : 0;
+	Hash = CityHash64WithSeed(reinterpret_cast<const char*>(List.VtxBuffer.Data), List.VtxBuffer.size_in_bytes(), Hash);
+	Hash = CityHash64WithSeed(reinterpret_cast<const char*>(List.IdxBuffer.Data), List.IdxBuffer.size_in_bytes(), Hash);
+
+	// Hash command fields one by one, to skip padding and callbacks that are not used by the widget.
+	for (const ImDrawCmd& ImGuiCommand : List.CmdBuffer)
+	{
+		const uint32 Offsets[] = { ImGuiCommand.ElemCount, ImGuiCommand.VtxOffset, ImGuiCommand.IdxOffset };
+		Hash = CityHash64WithSeed(reinterpret_cast<const char*>(Offsets), sizeof(Offsets), Hash);
+		Hash = CityHash64WithSeed(reinterpret_cast<const char*>(&ImGuiCommand.ClipRect), sizeof(ImGuiCommand.ClipRect), Hash);
+		Hash = CityHash64WithSeed(reinterpret_cast<const char*>(&ImGuiCommand.TextureId), sizeof(ImGuiCommand.TextureId), Hash);
+	}
+
+	return Hash;
+}
+
+SIZE_T FImGuiDrawList::GetAllocatedSize() const
+{
+	return CommandVertexRanges.GetAllocatedSize() + CommandTextures.GetAllocatedSize() + SlateVertexBuffer.GetAllocatedSize()
+		+ SlateIndexBuffer.GetAllocatedSize() + TransformedVertexBuffer.GetAllocatedSize();
+}
+
+void FImGuiDrawList::UpdateTransformedVertices(const FTransform2D& Transform) const
+{
+	// Widget transform rarely changes, so transformed vertices can be reused for as long as the list content stays
+	// the same.
+	if (bHasTransformedData && Transform == TransformedVertexBufferTransform)
+	{
+		INC_DWORD_STAT(STAT_ImGui_DrawListTransformHits);
+		return;
+	}
+
+	INC_DWORD_STAT(STAT_ImGui_DrawListTransformMisses);
+
+	TransformedVertexBuffer.SetNumUninitialized(SlateVertexBuffer.Num(), false);
+	FMemory::Memcpy(TransformedVertexBuffer.GetData(), SlateVertexBuffer.GetData(), SlateVertexBuffer.Num() * sizeof(FSlateVertex));
+	ImGuiVertexConversion::TransformPositions(TransformedVertexBuffer.GetData(), TransformedVertexBuffer.Num(), Transform);
+
+	TransformedVertexBufferTransform = Transform;
+	bHasTransformedData = true;
+}
+
+void FImGuiDrawList::UpdateVertexRanges()
+{
+	// ImGui appends vertices sequentially, so each command references a compact range of vertices. Finding those
+	// ranges allows to copy only vertices used by the command, instead of copying the whole buffer for every command.
+	// Indices are relative to the command's VtxOffset, which allows ImGui to output lists with more than 64K vertices
+	// when using 16-bit indices.
+	CommandVertexRanges.SetNumUninitialized(ImGuiCommandBuffer.Size, false);
+
+	for (int CommandNb = 0; CommandNb < ImGuiCommandBuffer.Size; CommandNb++)
+	{
+		const ImDrawCmd& ImGuiCommand = ImGuiCommandBuffer[CommandNb];
+
+		uint32 MinIndex = MAX_uint32;
+		uint32 MaxIndex = 0;
+		for (uint32 i = 0; i < ImGuiCommand.ElemCount; i++)
+		{
+			const uint32 Index = ImGuiIndexBuffer[ImGuiCommand.IdxOffset + i];
+			MinIndex = FMath::Min(MinIndex, Index);
+			MaxIndex = FMath::Max(MaxIndex, Index);
+		}
+
+		CommandVertexRanges[CommandNb] = (MinIndex <= MaxIndex)
+			? FVertexRange{ ImGuiCommand.VtxOffset + MinIndex, MaxIndex - MinIndex + 1, MinIndex }
+			: FVertexRange{ 0, 0, 0 };
+	}
 }
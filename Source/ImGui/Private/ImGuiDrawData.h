@@ -3,6 +3,7 @@
 #pragma once
 
 #include "ImGuiInteroperability.h"
+#include "TextureManager.h"
 #include "VersionCompatibility.h"
 
 #include <Rendering/RenderingCommon.h>
@@ -16,6 +17,17 @@ struct FImGuiDrawCommand
 	uint32 NumElements;
 	FSlateRect ClippingRect;
 	TextureIndex TextureId;
+
+	// Offset of the first index used by this command.
+	uint32 IndexOffset;
+
+	// Range of vertices referenced by this command.
+	uint32 VertexOffset;
+	uint32 NumVertices;
+
+	// Range of ImGui commands represented by this command (more than one after merging).
+	int FirstCommandNb;
+	int NumCommands;
 };
 
 // Wraps raw ImGui draw list data in utilities that transform them for Slate.
@@ -33,36 +45,150 @@ public:
 	FImGuiDrawCommand GetCommand(int CommandNb, const FTransform2D& Transform) const
 	{
 		const ImDrawCmd& ImGuiCommand = ImGuiCommandBuffer[CommandNb];
+		const FVertexRange& VertexRange = CommandVertexRanges[CommandNb];
 		return { ImGuiCommand.ElemCount, TransformRect(Transform, ImGuiInterops::ToSlateRect(ImGuiCommand.ClipRect)),
-			ImGuiInterops::ToTextureIndex(ImGuiCommand.TextureId) };
+			CommandTextures[CommandNb], ImGuiCommand.IdxOffset, VertexRange.Offset, VertexRange.Num, CommandNb, 1 };
+	}
+
+	// Get the texture of a draw command as set in ImGui, before resolving atlas pages.
+	FORCEINLINE TextureIndex GetSourceTexture(int CommandNb) const
+	{
+		return ImGuiInterops::ToTextureIndex(ImGuiCommandBuffer[CommandNb].TextureId);
 	}
 
+	// Check whether the next draw command can be merged into the given one. Merged commands are drawn with a single range
+	// of vertices, which needs to be addressable with Slate indices (16-bit on some platforms).
+	// @param Command - Draw command to extend
+	// @param NextCommand - Draw command directly following the extended command
+	// @returns True, if the range of vertices after merging fits in the range of Slate indices
+	static bool CanMergeCommands(const FImGuiDrawCommand& Command, const FImGuiDrawCommand& NextCommand);
+
+	// Merge the next draw command into the given one, so both can be drawn as a single Slate element. Caller needs to
+	// make sure that commands are consecutive, that they share the same texture and effective clipping rectangle and
+	// that they can be merged (see CanMergeCommands).
+	// @param Command - Draw command extended to also represent the next command
+	// @param NextCommand - Draw command directly following the extended command
+	static void MergeCommands(FImGuiDrawCommand& Command, const FImGuiDrawCommand& NextCommand);
+
+	// Get the hash of the name of the window that owns this list.
+	FORCEINLINE uint64 GetOwnerHash() const { return OwnerHash; }
+
+	// Get the number of vertices in this list.
+	FORCEINLINE int NumVertices() const { return ImGuiVertexBuffer.Size; }
+
+	// Call a function for every ImGui vertex referenced by draw commands that use the given texture (as set in ImGui).
+	// @param TextureId - ImGui texture id
+	// @param Function - Function taking a const reference to ImDrawVert
+	template<typename FunctionType>
+	void ForEachVertex(ImTextureID TextureId, FunctionType Function) const
+	{
+		for (int CommandNb = 0; CommandNb < ImGuiCommandBuffer.Size && CommandNb < CommandVertexRanges.Num(); CommandNb++)
+		{
+			if (ImGuiCommandBuffer[CommandNb].TextureId == TextureId)
+			{
+				const FVertexRange& VertexRange = CommandVertexRanges[CommandNb];
+				for (uint32 Index = VertexRange.Offset; Index < VertexRange.Offset + VertexRange.Num; Index++)
+				{
+					Function(ImGuiVertexBuffer[Index]);
+				}
+			}
+		}
+	}
+
+	// Get bounds of all vertices in this list (calculated during conversion).
+	// @param Transform - Transform to apply to bounds
+	// @returns Transformed bounds
+	FORCEINLINE FSlateRect GetVertexBounds(const FTransform2D& Transform) const { return TransformRect(Transform, VertexBounds); }
+
 #if ENGINE_COMPATIBILITY_LEGACY_CLIPPING_API
-	// Transform and copy vertex data to target buffer (old data in the target buffer are replaced).
+	// Copy and transform vertices referenced by a draw command to target buffer (old data in the target buffer are
+	// replaced).
 	// @param OutVertexBuffer - Destination buffer
 	// @param Transform - Transform to apply to all vertices
 	// @param VertexClippingRect - Clipping rectangle for transformed Slate vertices
-	void CopyVertexData(TArray<FSlateVertex>& OutVertexBuffer, const FTransform2D& Transform, const FSlateRotatedRect& VertexClippingRect) const;
+	// @param Command - Draw command defining the range of vertices to copy
+	void CopyVertexData(TArray<FSlateVertex>& OutVertexBuffer, const FTransform2D& Transform, const FSlateRotatedRect& VertexClippingRect, const FImGuiDrawCommand& Command) const;
 #else
-	// Transform and copy vertex data to target buffer (old data in the target buffer are replaced).
+	// Copy and transform vertices referenced by a draw command to target buffer (old data in the target buffer are
+	// replaced).
 	// @param OutVertexBuffer - Destination buffer
 	// @param Transform - Transform to apply to all vertices
-	void CopyVertexData(TArray<FSlateVertex>& OutVertexBuffer, const FTransform2D& Transform) const;
+	// @param Command - Draw command defining the range of vertices to copy
+	void CopyVertexData(TArray<FSlateVertex>& OutVertexBuffer, const FTransform2D& Transform, const FImGuiDrawCommand& Command) const;
 #endif // ENGINE_COMPATIBILITY_LEGACY_CLIPPING_API
 
-	// Transform and copy index data to target buffer (old data in the target buffer are replaced).
-	// Internal index buffer contains enough data to match the sum of NumElements from all draw commands.
+	// Copy indices of a draw command to target buffer (old data in the target buffer are replaced). Indices are rebased
+	// to address the vertices copied with CopyVertexData for the same command.
 	// @param OutIndexBuffer - Destination buffer
-	// @param StartIndex - Start copying source data starting from this index
-	// @param NumElements - How many elements we want to copy
-	void CopyIndexData(TArray<SlateIndex>& OutIndexBuffer, const int32 StartIndex, const int32 NumElements) const;
+	// @param Command - Draw command defining the range of indices to copy
+	void CopyIndexData(TArray<SlateIndex>& OutIndexBuffer, const FImGuiDrawCommand& Command) const;
+
+	// Calculate a hash of the content of an ImGui draw list, used to detect lists that didn't change between frames.
+	// @param List - ImGui draw list
+	// @returns Hash of the list's owner, vertices, indices and draw commands
+	static uint64 CalculateContentHash(const ImDrawList& List);
+
+	// Get the hash of the content transferred to this list (see CalculateContentHash).
+	FORCEINLINE uint64 GetContentHash() const { return ContentHash; }
 
 	// Transfers data from ImGui source list to this object. Leaves source cleared.
-	void TransferDrawData(ImDrawList& Src);
+	// @param Src - ImGui draw list
+	// @param InContentHash - Hash of the source content calculated with CalculateContentHash
+	void TransferDrawData(ImDrawList& Src, uint64 InContentHash);
+
+	// Converts transferred data to Slate format, so copying draw commands only needs to transform vertex positions.
+	// It doesn't access ImGui context, so different lists can be converted in parallel. If the content of the list is
+	// the same as in the previous frame, data converted back then is reused.
+	// @param TextureManager - If not null, it is used to draw textures packed into atlas pages with their pages
+	void ConvertDrawData(const FTextureManager* TextureManager);
+
+	// Get the number of bytes allocated for data converted to Slate format. Memory of buffers transferred from ImGui is
+	// owned by the context that created them.
+	SIZE_T GetAllocatedSize() const;
 
 private:
 
+	// Range of vertices referenced by a single draw command.
+	struct FVertexRange
+	{
+		uint32 Offset;
+		uint32 Num;
+		uint32 IndexRebase;
+	};
+
+	// Find ranges of vertices referenced by draw commands.
+	void UpdateVertexRanges();
+
+	// Resolve textures of draw commands, remapping UVs of vertices that use textures packed into atlas pages.
+	void ResolveCommandTextures(const FTextureManager* TextureManager);
+
+	// Transform converted vertices, if they were not already transformed with the same transform.
+	void UpdateTransformedVertices(const FTransform2D& Transform) const;
+
 	ImVector<ImDrawCmd> ImGuiCommandBuffer;
 	ImVector<ImDrawIdx> ImGuiIndexBuffer;
 	ImVector<ImDrawVert> ImGuiVertexBuffer;
+
+	TArray<FVertexRange> CommandVertexRanges;
+
+	// Textures used to draw commands (atlas pages for textures packed into them).
+	TArray<TextureIndex> CommandTextures;
+
+	// Data converted to Slate format with positions in ImGui space.
+	TArray<FSlateVertex> SlateVertexBuffer;
+	TArray<SlateIndex> SlateIndexBuffer;
+
+	// Converted vertices with positions in the space of the last transform used to copy vertex data.
+	mutable TArray<FSlateVertex> TransformedVertexBuffer;
+	mutable FTransform2D TransformedVertexBufferTransform;
+
+	// Bounds of converted vertices in ImGui space.
+	FSlateRect VertexBounds{ 0.f, 0.f, 0.f, 0.f };
+
+	uint64 OwnerHash = 0;
+	uint64 ContentHash = 0;
+	uint64 Fingerprint = 0;
+
+	bool bHasConvertedData = false;
+	mutable bool bHasTransformedData = false;
 };
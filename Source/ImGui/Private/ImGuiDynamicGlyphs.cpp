@@ -0,0 +1,348 @@
+// Distributed under the MIT License (MIT) (see accompanying LICENSE file)
+
+#include "ImGuiDynamicGlyphs.h"
+
+#include "ImGuiContextArena.h"
+#include "ImGuiDrawData.h"
+
+#include <Containers/Set.h>
+
+
+namespace
+{
+	// Custom rectangles need ids above the Unicode range.
+	constexpr uint32 CellsRectId = 0x110000;
+
+	// Smallest atlas width set to fit cells (the same as the smallest width selected by ImGui).
+	constexpr int32 MinAtlasWidth = 512;
+
+	// Bits for all codepoints supported by ImGui.
+	constexpr int32 NumCodepoints = 0x10000;
+}
+
+void FImGuiDynamicGlyphs::Reserve(ImFontAtlas& FontAtlas, int32 Capacity)
+{
+	checkf(FontAtlas.ConfigData.Size > 0 && !FontAtlas.IsBuilt(),
+		TEXT("Cells for dynamic glyphs should be reserved after adding fonts and before building the font atlas."));
+
+	Cells.Reset();
+	CodepointToCell.Reset();
+	RectIndex = INDEX_NONE;
+
+	if (Capacity <= 0)
+	{
+		return;
+	}
+
+	// Cells leave some margin above the font size and padding between glyphs.
+	const int32 Padding = FontAtlas.TexGlyphPadding;
+	CellSize = FMath::CeilToInt(FontAtlas.ConfigData[0].SizePixels * 1.25f) + Padding;
+
+	// Atlas width is selected to fit cells in a roughly square rectangle. ImGui adjusts the height to fit everything.
+	const int64 Area = static_cast<int64>(Capacity) * CellSize * CellSize;
+	int32 AtlasWidth = MinAtlasWidth;
+	while (static_cast<int64>(AtlasWidth) * AtlasWidth < Area || AtlasWidth < CellSize + Padding)
+	{
+		AtlasWidth *= 2;
+	}
+
+	NumColumns = (AtlasWidth - Padding) / CellSize;
+	const int32 NumRows = FMath::DivideAndRoundUp(Capacity, NumColumns);
+	FontAtlas.TexDesiredWidth = FMath::Max(FontAtlas.TexDesiredWidth, AtlasWidth);
+
+	RectIndex = FontAtlas.AddCustomRectRegular(CellsRectId, NumColumns * CellSize, NumRows * CellSize);
+	Cells.SetNum(NumColumns * NumRows);
+}
+
+void FImGuiDynamicGlyphs::Bind(const ImFontAtlas& FontAtlas)
+{
+	TexWidth = FontAtlas.TexWidth;
+	TexHeight = FontAtlas.TexHeight;
+
+	if (RectIndex != INDEX_NONE)
+	{
+		const ImFontAtlasCustomRect& Rect = FontAtlas.CustomRects[RectIndex];
+		checkf(Rect.ID == CellsRectId && Rect.IsPacked(), TEXT("Cells for dynamic glyphs were not packed into the font atlas."));
+
+		RectX = Rect.X;
+		RectY = Rect.Y;
+	}
+}
+
+FIntRect FImGuiDynamicGlyphs::AddGlyphs(ImFontAtlas& FontAtlas, const TArray<uint8>& FontData,
+	TArrayView<const ImWchar> Codepoints, TArray<ImWchar>& OutMissingCodepoints)
+{
+	FIntRect DirtyRect;
+
+	if (Cells.Num() == 0 || FontData.Num() == 0 || FontAtlas.Fonts.Size == 0 || !FontAtlas.TexPixelsAlpha8)
+	{
+		return DirtyRect;
+	}
+
+	// Only glyphs for which there are cells are rasterized. Others can be added after some glyphs are no longer drawn.
+	const TArray<int32> AvailableCells = GetAvailableCells();
+
+	TArray<ImWchar> NewCodepoints;
+	TBitArray<> IsNewCodepoint(false, NumCodepoints);
+	for (ImWchar Codepoint : Codepoints)
+	{
+		if (NewCodepoints.Num() == AvailableCells.Num())
+		{
+			break;
+		}
+
+		if (Codepoint > 0 && !Contains(Codepoint) && !IsNewCodepoint[Codepoint])
+		{
+			NewCodepoints.Add(Codepoint);
+			IsNewCodepoint[Codepoint] = true;
+		}
+	}
+
+	if (NewCodepoints.Num() == 0)
+	{
+		return DirtyRect;
+	}
+
+	// Font atlas is shared by all contexts, so its allocations should not be counted by a context that is current
+	// in this thread.
+	FImGuiContextArena::FNeutralScope NeutralArenaScope;
+
+	// Merge consecutive codepoints into inclusive ranges, terminated with zero.
+	NewCodepoints.Sort();
+	TArray<ImWchar> Ranges;
+	for (ImWchar Codepoint : NewCodepoints)
+	{
+		if (Ranges.Num() > 0 && Ranges.Last() + 1 == Codepoint)
+		{
+			Ranges.Last() = Codepoint;
+		}
+		else
+		{
+			Ranges.Add(Codepoint);
+			Ranges.Add(Codepoint);
+		}
+	}
+	Ranges.Add(0);
+
+	ImFont* Font = FontAtlas.Fonts[0];
+	const ImFontConfig& FontConfig = *Font->ConfigData;
+
+	// Glyphs are rasterized in a small atlas, where the glyph font is merged into the default font in the same way as
+	// it would be in a full build, so glyphs get the same metrics. Only the space is taken from the default font.
+	ImFontAtlas GlyphAtlas;
+	GlyphAtlas.Flags = FontAtlas.Flags | ImFontAtlasFlags_NoMouseCursors;
+	GlyphAtlas.TexGlyphPadding = FontAtlas.TexGlyphPadding;
+
+	static const ImWchar DefaultFontRanges[] = { 0x20, 0x20, 0 };
+	ImFontConfig DefaultFontConfig = FontConfig;
+	DefaultFontConfig.FontData = nullptr;
+	DefaultFontConfig.FontDataSize = 0;
+	DefaultFontConfig.DstFont = nullptr;
+	DefaultFontConfig.GlyphRanges = DefaultFontRanges;
+	GlyphAtlas.AddFontDefault(&DefaultFontConfig);
+
+	// Font data are shared with other builds, so they cannot be owned by the atlas. Horizontal oversampling is disabled,
+	// so glyphs fit in cells.
+	ImFontConfig GlyphFontConfig = {};
+	GlyphFontConfig.MergeMode = true;
+	GlyphFontConfig.FontDataOwnedByAtlas = false;
+	GlyphFontConfig.OversampleH = 1;
+	GlyphFontConfig.PixelSnapH = true;
+	GlyphAtlas.AddFontFromMemoryTTF(const_cast<uint8*>(FontData.GetData()), FontData.Num(), FontConfig.SizePixels,
+		&GlyphFontConfig, Ranges.GetData());
+
+	unsigned char* GlyphPixels;
+	int GlyphTexWidth, GlyphTexHeight;
+	GlyphAtlas.GetTexDataAsAlpha8(&GlyphPixels, &GlyphTexWidth, &GlyphTexHeight);
+
+	// Tab glyph is added by BuildLookupTable at the end of the glyph list, so it needs to be removed before updating
+	// glyphs.
+	if (Font->Glyphs.Size > 0 && Font->Glyphs.back().Codepoint == '\t')
+	{
+		Font->Glyphs.pop_back();
+	}
+
+	TSet<ImWchar> ReplacedCodepoints;
+	int32 NextCellNb = 0;
+
+	for (const ImFontGlyph& Glyph : GlyphAtlas.Fonts[0]->Glyphs)
+	{
+		if (!IsNewCodepoint[Glyph.Codepoint] || NextCellNb == AvailableCells.Num())
+		{
+			continue;
+		}
+
+		// Glyphs that are not in the glyph font are not rasterized, so remaining bits mark missing glyphs.
+		IsNewCodepoint[Glyph.Codepoint] = false;
+
+		const int32 SrcX = FMath::RoundToInt(Glyph.U0 * GlyphTexWidth);
+		const int32 SrcY = FMath::RoundToInt(Glyph.V0 * GlyphTexHeight);
+		const int32 Width = FMath::RoundToInt(Glyph.U1 * GlyphTexWidth) - SrcX;
+		const int32 Height = FMath::RoundToInt(Glyph.V1 * GlyphTexHeight) - SrcY;
+		if (Width + FontAtlas.TexGlyphPadding > CellSize || Height + FontAtlas.TexGlyphPadding > CellSize)
+		{
+			OutMissingCodepoints.Add(Glyph.Codepoint);
+			continue;
+		}
+
+		const int32 CellIndex = AvailableCells[NextCellNb++];
+		FCell& Cell = Cells[CellIndex];
+		if (Cell.Codepoint)
+		{
+			CodepointToCell.Remove(Cell.Codepoint);
+			ReplacedCodepoints.Add(Cell.Codepoint);
+		}
+
+		// New glyphs count as drawn in the next update, so they are not replaced before they can be drawn.
+		Cell.Codepoint = Glyph.Codepoint;
+		Cell.LastDrawStamp = DrawStamp + 1;
+		CodepointToCell.Add(Glyph.Codepoint, CellIndex);
+
+		// Copy the glyph to the cell, clearing the rest of the cell.
+		const int32 CellX = RectX + (CellIndex % NumColumns) * CellSize;
+		const int32 CellY = RectY + (CellIndex / NumColumns) * CellSize;
+		for (int32 Row = 0; Row < CellSize; Row++)
+		{
+			uint8* Dst = FontAtlas.TexPixelsAlpha8 + (CellY + Row) * TexWidth + CellX;
+			if (Row < Height)
+			{
+				FMemory::Memcpy(Dst, GlyphPixels + (SrcY + Row) * GlyphTexWidth + SrcX, Width);
+				FMemory::Memzero(Dst + Width, CellSize - Width);
+			}
+			else
+			{
+				FMemory::Memzero(Dst, CellSize);
+			}
+		}
+
+		const FIntRect CellRect{ CellX, CellY, CellX + CellSize, CellY + CellSize };
+		if (DirtyRect.Area() > 0)
+		{
+			DirtyRect.Union(CellRect);
+		}
+		else
+		{
+			DirtyRect = CellRect;
+		}
+
+		// Advance is passed without spacing, which is added again by the font.
+		Font->AddGlyph(Glyph.Codepoint, Glyph.X0, Glyph.Y0, Glyph.X1, Glyph.Y1,
+			CellX * FontAtlas.TexUvScale.x, CellY * FontAtlas.TexUvScale.y,
+			(CellX + Width) * FontAtlas.TexUvScale.x, (CellY + Height) * FontAtlas.TexUvScale.y,
+			Glyph.AdvanceX - FontConfig.GlyphExtraSpacing.x);
+	}
+
+	for (ImWchar Codepoint : NewCodepoints)
+	{
+		if (IsNewCodepoint[Codepoint])
+		{
+			OutMissingCodepoints.Add(Codepoint);
+		}
+	}
+
+	if (ReplacedCodepoints.Num() > 0)
+	{
+		for (int32 Index = Font->Glyphs.Size - 1; Index >= 0; Index--)
+		{
+			if (ReplacedCodepoints.Contains(Font->Glyphs[Index].Codepoint))
+			{
+				Font->Glyphs.erase_unsorted(Font->Glyphs.Data + Index);
+			}
+		}
+	}
+
+	Font->BuildLookupTable();
+
+	return DirtyRect;
+}
+
+TArray<ImWchar> FImGuiDynamicGlyphs::GetCodepointsByLastDraw() const
+{
+	TArray<int32> UsedCells;
+	for (int32 CellIndex = 0; CellIndex < Cells.Num(); CellIndex++)
+	{
+		if (Cells[CellIndex].Codepoint)
+		{
+			UsedCells.Add(CellIndex);
+		}
+	}
+
+	UsedCells.Sort([this](int32 A, int32 B) { return Cells[A].LastDrawStamp > Cells[B].LastDrawStamp; });
+
+	TArray<ImWchar> Codepoints;
+	Codepoints.Reserve(UsedCells.Num());
+	for (int32 CellIndex : UsedCells)
+	{
+		Codepoints.Add(Cells[CellIndex].Codepoint);
+	}
+	return Codepoints;
+}
+
+void FImGuiDynamicGlyphs::FindDrawnGlyphs(const FImGuiDrawList& DrawList, ImTextureID FontTexture, TBitArray<>& DrawnCells) const
+{
+	if (Cells.Num() == 0)
+	{
+		return;
+	}
+
+	const int32 CellsWidth = NumColumns * CellSize;
+	const int32 CellsHeight = (Cells.Num() / NumColumns) * CellSize;
+
+	// Vertices of a glyph are in the corners of its rectangle, which is inside of a single cell (rounding to the
+	// nearest texel protects against precision errors).
+	DrawList.ForEachVertex(FontTexture, [&](const ImDrawVert& Vertex)
+	{
+		const int32 X = FMath::FloorToInt(Vertex.uv.x * TexWidth + 0.5f) - RectX;
+		const int32 Y = FMath::FloorToInt(Vertex.uv.y * TexHeight + 0.5f) - RectY;
+		if (X >= 0 && Y >= 0 && X < CellsWidth && Y < CellsHeight)
+		{
+			DrawnCells[(Y / CellSize) * NumColumns + X / CellSize] = true;
+		}
+	});
+}
+
+void FImGuiDynamicGlyphs::MarkDrawn(const TBitArray<>& DrawnCells)
+{
+	for (TConstSetBitIterator<> It(DrawnCells); It; ++It)
+	{
+		if (It.GetIndex() < Cells.Num())
+		{
+			Cells[It.GetIndex()].LastDrawStamp = DrawStamp;
+		}
+	}
+}
+
+void FImGuiDynamicGlyphs::CopyDrawOrder(const FImGuiDynamicGlyphs& Other)
+{
+	DrawStamp = FMath::Max(DrawStamp, Other.DrawStamp);
+
+	for (FCell& Cell : Cells)
+	{
+		if (Cell.Codepoint)
+		{
+			const int32* OtherCellIndex = Other.CodepointToCell.Find(Cell.Codepoint);
+			Cell.LastDrawStamp = OtherCellIndex ? Other.Cells[*OtherCellIndex].LastDrawStamp : DrawStamp + 1;
+		}
+	}
+}
+
+TArray<int32> FImGuiDynamicGlyphs::GetAvailableCells() const
+{
+	TArray<int32> AvailableCells;
+	TArray<int32> ReplaceableCells;
+	for (int32 CellIndex = 0; CellIndex < Cells.Num(); CellIndex++)
+	{
+		if (!Cells[CellIndex].Codepoint)
+		{
+			AvailableCells.Add(CellIndex);
+		}
+		else if (Cells[CellIndex].LastDrawStamp < DrawStamp)
+		{
+			ReplaceableCells.Add(CellIndex);
+		}
+	}
+
+	ReplaceableCells.Sort([this](int32 A, int32 B) { return Cells[A].LastDrawStamp < Cells[B].LastDrawStamp; });
+	AvailableCells.Append(ReplaceableCells);
+	return AvailableCells;
+}
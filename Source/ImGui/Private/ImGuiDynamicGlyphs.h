@@ -0,0 +1,103 @@
+// Distributed under the MIT License (MIT) (see accompanying LICENSE file)
+
+#pragma once
+
+#include <Containers/Array.h>
+#include <Containers/ArrayView.h>
+#include <Containers/BitArray.h>
+#include <Containers/Map.h>
+#include <Math/IntRect.h>
+
+#include <imgui.h>
+
+
+class FImGuiDrawList;
+
+// Glyphs added on demand to the default font of a built font atlas. Glyphs are rasterized into cells of a rectangle
+// reserved in the atlas before it is built, so adding them only needs to update lookup tables of the font and a small
+// part of the atlas texture. When all cells are taken, cells of glyphs that were not drawn for the longest time are
+// reused.
+class FImGuiDynamicGlyphs
+{
+public:
+
+	// Reserve cells for glyphs in a font atlas that is not built yet. Default font should already be added. Cells are
+	// reserved as a custom rectangle, so they are a part of the font atlas cache key.
+	// @param FontAtlas - Font atlas with added fonts
+	// @param Capacity - Number of glyphs for which cells should be reserved (nothing is reserved, if not positive)
+	void Reserve(ImFontAtlas& FontAtlas, int32 Capacity);
+
+	// Find cells reserved with Reserve, after the font atlas is built or loaded from the cache.
+	// @param FontAtlas - The same font atlas, after it is built
+	void Bind(const ImFontAtlas& FontAtlas);
+
+	// Rasterize glyphs and add them to the default font. If there are no free cells, glyphs that were not drawn in the
+	// last draw update are replaced. Lookup tables of the font are rebuilt, so it should only be called when no context
+	// is using the font.
+	// @param FontAtlas - Built font atlas with bound cells
+	// @param FontData - Data of a font from which glyphs are taken
+	// @param Codepoints - Glyphs to add (glyphs that are already added are skipped)
+	// @param OutMissingCodepoints - Receives glyphs that are not in the font or that don't fit in cells
+	// @returns Rectangle of updated atlas pixels (empty, if no glyphs were added)
+	FIntRect AddGlyphs(ImFontAtlas& FontAtlas, const TArray<uint8>& FontData, TArrayView<const ImWchar> Codepoints,
+		TArray<ImWchar>& OutMissingCodepoints);
+
+	// Check whether a glyph is in the font atlas.
+	bool Contains(ImWchar Codepoint) const { return CodepointToCell.Contains(Codepoint); }
+
+	// Get the number of glyphs in the font atlas.
+	int32 Num() const { return CodepointToCell.Num(); }
+
+	// Get the number of reserved cells.
+	int32 GetCapacity() const { return Cells.Num(); }
+
+	// Get glyphs in the font atlas, starting from the most recently drawn.
+	TArray<ImWchar> GetCodepointsByLastDraw() const;
+
+	// Start a new draw update. Glyphs marked as drawn in the last update are not replaced when adding new glyphs.
+	void BeginDrawUpdate() { DrawStamp++; }
+
+	// Find cells of glyphs drawn by a draw list.
+	// @param DrawList - Draw list to scan
+	// @param FontTexture - ImGui id of the font atlas texture
+	// @param DrawnCells - Bits of found cells are set in this array (it should have a bit for every cell)
+	void FindDrawnGlyphs(const FImGuiDrawList& DrawList, ImTextureID FontTexture, TBitArray<>& DrawnCells) const;
+
+	// Mark glyphs as drawn in the current draw update.
+	// @param DrawnCells - Cells of drawn glyphs (see FindDrawnGlyphs)
+	void MarkDrawn(const TBitArray<>& DrawnCells);
+
+	// Copy the order in which glyphs were drawn from glyphs reserved for a different build of the font atlas.
+	void CopyDrawOrder(const FImGuiDynamicGlyphs& Other);
+
+private:
+
+	struct FCell
+	{
+		// Glyph in this cell (zero if the cell is free).
+		ImWchar Codepoint = 0;
+
+		// Draw update in which the glyph was drawn for the last time.
+		uint32 LastDrawStamp = 0;
+	};
+
+	// Get cells that can be used for new glyphs: free cells first, followed by cells of glyphs that were not drawn in
+	// the last draw update, from the least recently drawn.
+	TArray<int32> GetAvailableCells() const;
+
+	TArray<FCell> Cells;
+	TMap<ImWchar, int32> CodepointToCell;
+
+	// Index of the custom rectangle with cells and its position in the atlas.
+	int32 RectIndex = INDEX_NONE;
+	int32 RectX = 0;
+	int32 RectY = 0;
+
+	int32 CellSize = 0;
+	int32 NumColumns = 0;
+
+	int32 TexWidth = 0;
+	int32 TexHeight = 0;
+
+	uint32 DrawStamp = 1;
+};
@@ -0,0 +1,394 @@
+// Distributed under the MIT License (MIT) (see accompanying LICENSE file)
+
+#include "ImGuiFontAtlasCache.h"
+
+#include "VersionCompatibility.h"
+
+#include <HAL/FileManager.h>
+#include <HAL/IConsoleManager.h>
+#include <Hash/CityHash.h>
+#include <Misc/FileHelper.h>
+#include <Misc/Paths.h>
+#include <Templates/UniquePtr.h>
+
+#include <imgui_internal.h>
+
+
+namespace CVars
+{
+	TAutoConsoleVariable<int> FontAtlasCache(TEXT("ImGui.FontAtlas.Cache"), 1,
+		TEXT("Whether built font atlases should be cached in the Saved/ImGui directory and loaded from there, instead of\n")
+		TEXT("rasterizing fonts every time when the atlas is built.\n")
+		TEXT("0: disabled\n")
+		TEXT("1: enabled (default)"),
+		ECVF_Default);
+
+	TAutoConsoleVariable<int> FontAtlasMaxCacheFiles(TEXT("ImGui.FontAtlas.MaxCacheFiles"), 8,
+		TEXT("Maximum number of font atlases kept in the cache. When exceeded, atlases that were not used for the longest\n")
+		TEXT("time are deleted."),
+		ECVF_Default);
+}
+
+namespace
+{
+	// Version of the cache format. It should be incremented after every change in the format or in the way how atlases
+	// are built.
+	constexpr uint32 CacheVersion = 1;
+	constexpr uint32 CacheMagic = 0x43414749; // 'IGAC'
+
+	struct FCacheHeader
+	{
+		uint32 Magic;
+		uint32 Version;
+		uint64 Key;
+		int32 TexWidth;
+		int32 TexHeight;
+		ImVec2 TexUvScale;
+		ImVec2 TexUvWhitePixel;
+		int32 NumCustomRects;
+		int32 NumFonts;
+	};
+
+	struct FCachedCustomRect
+	{
+		uint16 X;
+		uint16 Y;
+	};
+
+	struct FCachedFont
+	{
+		float FontSize;
+		float Ascent;
+		float Descent;
+		int32 MetricsTotalSurface;
+		int32 NumGlyphs;
+		int32 EllipsisChar;
+	};
+
+	// Reads data from a file, failing if there are not enough data left.
+	struct FCacheReader
+	{
+		FCacheReader(FArchive& InArchive)
+			: Archive(InArchive)
+			, Size(InArchive.TotalSize())
+		{
+		}
+
+		bool Read(void* Dst, int64 ReadSize)
+		{
+			if (ReadSize < 0 || Offset + ReadSize > Size)
+			{
+				return false;
+			}
+
+			Archive.Serialize(Dst, ReadSize);
+			Offset += ReadSize;
+			return !Archive.IsError();
+		}
+
+		int64 GetRemainingSize() const { return Size - Offset; }
+
+		FArchive& Archive;
+		int64 Size = 0;
+		int64 Offset = 0;
+	};
+
+	FORCEINLINE void Write(TArray<uint8>& Data, const void* Src, int64 Size)
+	{
+		Data.Append(static_cast<const uint8*>(Src), static_cast<int32>(Size));
+	}
+
+	FORCEINLINE void HashBytes(uint64& Hash, const void* Data, SIZE_T Size)
+	{
+		Hash = CityHash64WithSeed(static_cast<const char*>(Data), Size, Hash);
+	}
+
+	template<typename T>
+	FORCEINLINE void HashValue(uint64& Hash, const T& Value)
+	{
+		HashBytes(Hash, &Value, sizeof(T));
+	}
+
+	int32 GetFontIndex(const ImFontAtlas& FontAtlas, const ImFont* Font)
+	{
+		const int32 Index = static_cast<int32>(FontAtlas.Fonts.find(const_cast<ImFont*>(Font)) - FontAtlas.Fonts.begin());
+		return Index < FontAtlas.Fonts.Size ? Index : INDEX_NONE;
+	}
+
+	// Hash of everything that affects the build. Structures are hashed field by field because they contain pointers
+	// and padding.
+	uint64 CalculateKey(ImFontAtlas& FontAtlas)
+	{
+		uint64 Hash = 0;
+
+		HashValue(Hash, CacheVersion);
+		HashValue(Hash, IMGUI_VERSION_NUM);
+		HashValue(Hash, sizeof(ImFontGlyph));
+
+		HashValue(Hash, FontAtlas.Flags);
+		HashValue(Hash, FontAtlas.TexDesiredWidth);
+		HashValue(Hash, FontAtlas.TexGlyphPadding);
+
+		for (const ImFontConfig& Config : FontAtlas.ConfigData)
+		{
+			HashBytes(Hash, Config.FontData, Config.FontDataSize);
+			HashValue(Hash, Config.FontNo);
+			HashValue(Hash, Config.SizePixels);
+			HashValue(Hash, Config.OversampleH);
+			HashValue(Hash, Config.OversampleV);
+			HashValue(Hash, Config.PixelSnapH);
+			HashValue(Hash, Config.GlyphExtraSpacing);
+			HashValue(Hash, Config.GlyphOffset);
+			HashValue(Hash, Config.GlyphMinAdvanceX);
+			HashValue(Hash, Config.GlyphMaxAdvanceX);
+			HashValue(Hash, Config.MergeMode);
+			HashValue(Hash, Config.RasterizerFlags);
+			HashValue(Hash, Config.RasterizerMultiply);
+			HashValue(Hash, Config.EllipsisChar);
+			HashValue(Hash, GetFontIndex(FontAtlas, Config.DstFont));
+
+			// Ranges are zero-terminated pairs.
+			const ImWchar* Ranges = Config.GlyphRanges ? Config.GlyphRanges : FontAtlas.GetGlyphRangesDefault();
+			const ImWchar* RangesEnd = Ranges;
+			while (RangesEnd[0] && RangesEnd[1])
+			{
+				RangesEnd += 2;
+			}
+			HashBytes(Hash, Ranges, (RangesEnd - Ranges) * sizeof(ImWchar));
+		}
+
+		for (const ImFontAtlasCustomRect& Rect : FontAtlas.CustomRects)
+		{
+			HashValue(Hash, Rect.ID);
+			HashValue(Hash, Rect.Width);
+			HashValue(Hash, Rect.Height);
+			HashValue(Hash, Rect.GlyphAdvanceX);
+			HashValue(Hash, Rect.GlyphOffset);
+			HashValue(Hash, GetFontIndex(FontAtlas, Rect.Font));
+		}
+
+		return Hash;
+	}
+
+	FString GetCacheFile(uint64 Key)
+	{
+#if ENGINE_COMPATIBILITY_LEGACY_SAVED_DIR
+		const FString SavedDir = FPaths::GameSavedDir();
+#else
+		const FString SavedDir = FPaths::ProjectSavedDir();
+#endif
+
+		return FPaths::Combine(*SavedDir, TEXT("ImGui"), *FString::Printf(TEXT("FontAtlas_%016llx.cache"), Key));
+	}
+
+	bool IsEnabled()
+	{
+		return CVars::FontAtlasCache.GetValueOnAnyThread() > 0;
+	}
+
+	// Delete the least recently used cache files, if there are more than allowed. Time stamps of files are updated
+	// when they are loaded, so atlases that are still in use are kept.
+	void PruneCacheFiles(const FString& CacheDirectory)
+	{
+		const int32 MaxCacheFiles = FMath::Max(CVars::FontAtlasMaxCacheFiles.GetValueOnAnyThread(), 1);
+
+		TArray<FString> FileNames;
+		IFileManager::Get().FindFiles(FileNames, *FPaths::Combine(*CacheDirectory, TEXT("FontAtlas_*.cache")), true, false);
+		if (FileNames.Num() <= MaxCacheFiles)
+		{
+			return;
+		}
+
+		TArray<TPair<FDateTime, FString>> Files;
+		for (const FString& FileName : FileNames)
+		{
+			const FString File = FPaths::Combine(*CacheDirectory, *FileName);
+			Files.Emplace(IFileManager::Get().GetTimeStamp(*File), File);
+		}
+
+		Files.Sort([](const TPair<FDateTime, FString>& A, const TPair<FDateTime, FString>& B) { return A.Key > B.Key; });
+
+		for (int32 Index = MaxCacheFiles; Index < Files.Num(); Index++)
+		{
+			IFileManager::Get().Delete(*Files[Index].Value, false, false, true);
+		}
+	}
+}
+
+namespace ImGuiFontAtlasCache
+{
+	bool Load(ImFontAtlas& FontAtlas)
+	{
+		if (!IsEnabled() || FontAtlas.Fonts.Size == 0)
+		{
+			return false;
+		}
+
+		// Default rectangles are normally registered during the build, but they need to be a part of the key.
+		ImFontAtlasBuildRegisterDefaultCustomRects(&FontAtlas);
+
+		const uint64 Key = CalculateKey(FontAtlas);
+
+		// Cache is validated before the atlas is modified. Glyphs and pixels are read directly into buffers that are
+		// then moved to the atlas.
+		const FString CacheFile = GetCacheFile(Key);
+		TUniquePtr<FArchive> Archive{ IFileManager::Get().CreateFileReader(*CacheFile, FILEREAD_Silent) };
+		if (!Archive)
+		{
+			return false;
+		}
+
+		FCacheReader Reader{ *Archive };
+
+		FCacheHeader Header;
+		if (!Reader.Read(&Header, sizeof(Header)) || Header.Magic != CacheMagic || Header.Version != CacheVersion
+			|| Header.Key != Key || Header.NumCustomRects != FontAtlas.CustomRects.Size || Header.NumFonts != FontAtlas.Fonts.Size
+			|| Header.TexWidth <= 0 || Header.TexHeight <= 0)
+		{
+			return false;
+		}
+
+		TArray<FCachedCustomRect> CustomRects;
+		CustomRects.SetNumUninitialized(Header.NumCustomRects);
+		if (!Reader.Read(CustomRects.GetData(), CustomRects.Num() * sizeof(FCachedCustomRect)))
+		{
+			return false;
+		}
+
+		TArray<FCachedFont> Fonts;
+		TArray<ImVector<ImFontGlyph>> Glyphs;
+		Fonts.SetNumZeroed(Header.NumFonts);
+		Glyphs.SetNum(Header.NumFonts);
+		for (int32 FontIndex = 0; FontIndex < Header.NumFonts; FontIndex++)
+		{
+			FCachedFont& Font = Fonts[FontIndex];
+			if (!Reader.Read(&Font, sizeof(Font)) || Font.NumGlyphs < 0
+				|| static_cast<int64>(sizeof(ImFontGlyph)) * Font.NumGlyphs > Reader.GetRemainingSize())
+			{
+				return false;
+			}
+
+			Glyphs[FontIndex].resize(Font.NumGlyphs);
+			if (!Reader.Read(Glyphs[FontIndex].Data, Glyphs[FontIndex].size_in_bytes()))
+			{
+				return false;
+			}
+		}
+
+		const int64 NumPixels = static_cast<int64>(Header.TexWidth) * Header.TexHeight;
+		if (Reader.GetRemainingSize() != NumPixels)
+		{
+			return false;
+		}
+
+		unsigned char* Pixels = static_cast<unsigned char*>(IM_ALLOC(NumPixels));
+		if (!Reader.Read(Pixels, NumPixels))
+		{
+			IM_FREE(Pixels);
+			return false;
+		}
+
+		Archive.Reset();
+
+		// Mark the file as recently used, so it is not pruned.
+		IFileManager::Get().SetTimeStamp(*CacheFile, FDateTime::UtcNow());
+
+		// Cache is valid, so we can set the atlas like it was built.
+		for (int32 Index = 0; Index < CustomRects.Num(); Index++)
+		{
+			FontAtlas.CustomRects[Index].X = CustomRects[Index].X;
+			FontAtlas.CustomRects[Index].Y = CustomRects[Index].Y;
+		}
+
+		FontAtlas.ClearTexData();
+		FontAtlas.TexWidth = Header.TexWidth;
+		FontAtlas.TexHeight = Header.TexHeight;
+		FontAtlas.TexUvScale = Header.TexUvScale;
+		FontAtlas.TexUvWhitePixel = Header.TexUvWhitePixel;
+		FontAtlas.TexPixelsAlpha8 = Pixels;
+
+		for (int32 FontIndex = 0; FontIndex < Fonts.Num(); FontIndex++)
+		{
+			const FCachedFont& CachedFont = Fonts[FontIndex];
+			ImFont* Font = FontAtlas.Fonts[FontIndex];
+
+			Font->ClearOutputData();
+			Font->ContainerAtlas = &FontAtlas;
+			Font->FontSize = CachedFont.FontSize;
+			Font->Ascent = CachedFont.Ascent;
+			Font->Descent = CachedFont.Descent;
+			Font->MetricsTotalSurface = CachedFont.MetricsTotalSurface;
+			Font->EllipsisChar = static_cast<ImWchar>(CachedFont.EllipsisChar);
+
+			Font->ConfigData = nullptr;
+			Font->ConfigDataCount = 0;
+			for (const ImFontConfig& Config : FontAtlas.ConfigData)
+			{
+				if (Config.DstFont == Font)
+				{
+					Font->ConfigData = Font->ConfigData ? Font->ConfigData : &Config;
+					Font->ConfigDataCount++;
+				}
+			}
+
+			Font->Glyphs.swap(Glyphs[FontIndex]);
+			Font->BuildLookupTable();
+		}
+
+		return true;
+	}
+
+	void Save(ImFontAtlas& FontAtlas)
+	{
+		if (!IsEnabled() || !FontAtlas.TexPixelsAlpha8)
+		{
+			return;
+		}
+
+		const uint64 Key = CalculateKey(FontAtlas);
+		const int64 NumPixels = static_cast<int64>(FontAtlas.TexWidth) * FontAtlas.TexHeight;
+
+		TArray<uint8> Data;
+		Data.Reserve(static_cast<int32>(sizeof(FCacheHeader) + NumPixels));
+
+		FCacheHeader Header;
+		Header.Magic = CacheMagic;
+		Header.Version = CacheVersion;
+		Header.Key = Key;
+		Header.TexWidth = FontAtlas.TexWidth;
+		Header.TexHeight = FontAtlas.TexHeight;
+		Header.TexUvScale = FontAtlas.TexUvScale;
+		Header.TexUvWhitePixel = FontAtlas.TexUvWhitePixel;
+		Header.NumCustomRects = FontAtlas.CustomRects.Size;
+		Header.NumFonts = FontAtlas.Fonts.Size;
+		Write(Data, &Header, sizeof(Header));
+
+		for (const ImFontAtlasCustomRect& Rect : FontAtlas.CustomRects)
+		{
+			const FCachedCustomRect CachedRect{ Rect.X, Rect.Y };
+			Write(Data, &CachedRect, sizeof(CachedRect));
+		}
+
+		for (const ImFont* Font : FontAtlas.Fonts)
+		{
+			const FCachedFont CachedFont{ Font->FontSize, Font->Ascent, Font->Descent, Font->MetricsTotalSurface,
+				Font->Glyphs.Size, Font->EllipsisChar };
+			Write(Data, &CachedFont, sizeof(CachedFont));
+			Write(Data, Font->Glyphs.Data, Font->Glyphs.size_in_bytes());
+		}
+
+		Write(Data, FontAtlas.TexPixelsAlpha8, NumPixels);
+
+		// Save to a temporary file first, so other processes never load a partially written cache.
+		const FString CacheFile = GetCacheFile(Key);
+		const FString CacheDirectory = FPaths::GetPath(CacheFile);
+		IFileManager::Get().MakeDirectory(*CacheDirectory, true);
+
+		const FString TempFile = FPaths::CreateTempFilename(*CacheDirectory, TEXT("FontAtlas"), TEXT(".tmp"));
+		if (FFileHelper::SaveArrayToFile(Data, *TempFile))
+		{
+			IFileManager::Get().Move(*CacheFile, *TempFile, true);
+			PruneCacheFiles(CacheDirectory);
+		}
+	}
+}
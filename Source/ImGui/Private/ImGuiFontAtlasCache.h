@@ -0,0 +1,22 @@
+// Distributed under the MIT License (MIT) (see accompanying LICENSE file)
+
+#pragma once
+
+#include <imgui.h>
+
+
+// Persistent cache of built font atlases, stored in the Saved/ImGui directory. Atlases are identified by a hash of
+// everything that affects their build (font data, sizes, glyph ranges, oversampling, etc.), so scales that result in the
+// same font sizes share the same cache file.
+namespace ImGuiFontAtlasCache
+{
+	// Load pixels and glyphs of a font atlas from the cache. Atlas should have all fonts added but it should not be built.
+	// Can be called from any thread, but ImGui context should not be set as current in that thread.
+	// @param FontAtlas - Font atlas with added fonts
+	// @returns True, if the atlas was loaded and it is built, false if there is no valid cache for that atlas
+	bool Load(ImFontAtlas& FontAtlas);
+
+	// Save pixels and glyphs of a built font atlas to the cache.
+	// @param FontAtlas - Built font atlas with Alpha8 pixels
+	void Save(ImFontAtlas& FontAtlas);
+}
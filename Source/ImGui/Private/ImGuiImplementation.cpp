@@ -17,12 +17,51 @@
 #include <Windows/AllowWindowsPlatformTypes.h>
 #endif // PLATFORM_WINDOWS
 
+#if IMGUI_THREAD_LOCAL_CONTEXT
+// Current context pointer set separately for each thread, what allows to update different contexts in parallel.
+static thread_local ImGuiContext* ImGuiThreadContextPtr = nullptr;
+#endif // IMGUI_THREAD_LOCAL_CONTEXT
+
 #if WITH_EDITOR
 
 #include "ImGuiModule.h"
 #include "Utilities/RedirectingHandle.h"
 
+#if IMGUI_THREAD_LOCAL_CONTEXT
+
+// Address of a thread-local variable is different in every thread, so instead of the context pointer, we share
+// a function that returns the context pointer for the calling thread.
+using FImGuiContextAccessor = ImGuiContext*& (*)();
+
+static ImGuiContext*& GetThreadContextPtr()
+{
+	return ImGuiThreadContextPtr;
+}
+
 // Redirecting handle which will automatically bind to another one, if a different instance of the module is loaded.
+struct FImGuiContextHandle : public Utilities::TRedirectingHandle<FImGuiContextAccessor>
+{
+	FImGuiContextHandle(FImGuiContextAccessor& InDefaultAccessor)
+		: Utilities::TRedirectingHandle<FImGuiContextAccessor>(InDefaultAccessor)
+	{
+		if (FImGuiModule* Module = FModuleManager::GetModulePtr<FImGuiModule>("ImGui"))
+		{
+			SetParent(Module->ImGuiContextHandle);
+		}
+	}
+};
+
+static FImGuiContextAccessor ImGuiContextAccessor = &GetThreadContextPtr;
+static FImGuiContextHandle ImGuiContextPtrHandle(ImGuiContextAccessor);
+
+// Get the ImGui context pointer (GImGui) for the calling thread indirectly to allow redirections in obsolete modules.
+#define GImGui (ImGuiContextPtrHandle.Get()())
+
+#else
+
+// Redirecting handle which will automatically bind to another one, if a different instance of the module is loaded.
+// Every module keeps a local copy of the current context pointer, so ImGui code can use it directly. Changes are
+// passed to the root of the redirection chain and from there to all redirected handles.
 struct FImGuiContextHandle : public Utilities::TRedirectingHandle<ImGuiContext*>
 {
 	FImGuiContextHandle(ImGuiContext*& InDefaultContext)
@@ -33,13 +72,77 @@ struct FImGuiContextHandle : public Utilities::TRedirectingHandle<ImGuiContext*>
 			SetParent(Module->ImGuiContextHandle);
 		}
 	}
+
+	~FImGuiContextHandle()
+	{
+		// Detach children while this handle is still complete, so they can unsubscribe from its context changes.
+		OnRedirectionUpdate.Broadcast(nullptr);
+		SetParent(nullptr);
+	}
+
+	// Set the current context in this and all the other linked modules.
+	void SetContext(ImGuiContext* Context)
+	{
+		FImGuiContextHandle* Root = this;
+		while (FImGuiContextHandle* ParentHandle = Root->GetParent())
+		{
+			Root = ParentHandle;
+		}
+
+		Root->UpdateContext(Context);
+	}
+
+private:
+
+	FImGuiContextHandle* GetParent() const { return static_cast<FImGuiContextHandle*>(Parent); }
+
+	// Parent can be changed by the base handle (e.g. when detaching from a destroyed parent), so context changes are
+	// followed from here rather than from SetParent.
+	virtual void OnParentChanged(Utilities::TRedirectingHandle<ImGuiContext*>* OldParent) override
+	{
+		if (OldParent)
+		{
+			static_cast<FImGuiContextHandle*>(OldParent)->OnContextChanged.RemoveAll(this);
+		}
+
+		if (FImGuiContextHandle* ParentHandle = GetParent())
+		{
+			ParentHandle->OnContextChanged.AddRaw(this, &FImGuiContextHandle::UpdateContext);
+		}
+	}
+
+	// Update the local context pointer, whenever this handle is redirected.
+	virtual void OnHandleChanged() override
+	{
+		UpdateContext(Get());
+	}
+
+	void UpdateContext(ImGuiContext* Context)
+	{
+		// Default handle points to the local copy, which for the root handle is also the shared value.
+		*DefaultHandle = Context;
+		OnContextChanged.Broadcast(Context);
+	}
+
+	DECLARE_MULTICAST_DELEGATE_OneParam(FContextChangedDelegate, ImGuiContext*);
+	FContextChangedDelegate OnContextChanged;
 };
 
 static ImGuiContext* ImGuiContextPtr = nullptr;
 static FImGuiContextHandle ImGuiContextPtrHandle(ImGuiContextPtr);
 
-// Get the global ImGui context pointer (GImGui) indirectly to allow redirections in obsolete modules.
-#define GImGui (ImGuiContextPtrHandle.Get())
+// Use the local copy of the context pointer directly as the global ImGui context pointer (GImGui) and pass changes
+// through the handle to keep all modules in sync, including obsolete ones after hot-reloading.
+#define GImGui ImGuiContextPtr
+#define IMGUI_SET_CURRENT_CONTEXT_FUNC(Context) ImGuiContextPtrHandle.SetContext(Context)
+
+#endif // IMGUI_THREAD_LOCAL_CONTEXT
+
+#elif IMGUI_THREAD_LOCAL_CONTEXT
+
+// Get the ImGui context pointer (GImGui) set for the calling thread.
+#define GImGui ImGuiThreadContextPtr
+
 #endif // WITH_EDITOR
 
 #include "imgui.cpp"
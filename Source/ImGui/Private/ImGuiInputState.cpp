@@ -50,9 +50,20 @@ void FImGuiInputState::ClearUpdateState()
 
 	MouseWheelDelta = 0.f;
 
+	bMousePositionUpdated = false;
 	bTouchProcessed = bTouchDown;
 }
 
+bool FImGuiInputState::HasUpdates() const
+{
+	using std::any_of;
+	const bool bHasNavigationInputs = any_of(NavigationInputs, &NavigationInputs[Utilities::GetArraySize(NavigationInputs)],
+		[](float Value) { return Value != 0.f; });
+
+	return InputCharacters.Num() > 0 || !KeysUpdateRange.IsEmpty() || !MouseButtonsUpdateRange.IsEmpty()
+		|| MouseWheelDelta != 0.f || bMousePositionUpdated || IsTouchActive() || bHasNavigationInputs;
+}
+
 void FImGuiInputState::ClearCharacters()
 {
 	InputCharacters.Empty();
@@ -80,6 +91,7 @@ void FImGuiInputState::ClearMouseAnalogue()
 {
 	MousePosition = FVector2D::ZeroVector;
 	MouseWheelDelta = 0.f;
+	bMousePositionUpdated = true;
 }
 
 void FImGuiInputState::ClearModifierKeys()
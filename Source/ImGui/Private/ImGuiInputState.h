@@ -86,7 +86,14 @@ public:
 
 	// Set the mouse position.
 	// @param Position - Mouse position
-	void SetMousePosition(const FVector2D& Position) { MousePosition = Position; }
+	void SetMousePosition(const FVector2D& Position)
+	{
+		if (MousePosition != Position)
+		{
+			MousePosition = Position;
+			bMousePositionUpdated = true;
+		}
+	}
 
 	// Check whether input has active mouse pointer.
 	bool HasMousePointer() const { return bHasMousePointer; }
@@ -201,6 +208,9 @@ public:
 	// and information about dirty parts of keys or mouse buttons arrays.
 	void ClearUpdateState();
 
+	// Check whether there were any input changes since the last time when update state was cleared.
+	bool HasUpdates() const;
+
 private:
 
 	void SetKeyDown(uint32 KeyIndex, bool bIsDown);
@@ -228,6 +238,7 @@ private:
 	FNavInputArray NavigationInputs;
 
 	bool bHasMousePointer = false;
+	bool bMousePositionUpdated = false;
 	bool bTouchDown = false;
 	bool bTouchProcessed = false;
 
@@ -3,6 +3,7 @@
 #include "ImGuiInteroperability.h"
 
 #include "ImGuiInputState.h"
+#include "ImGuiModuleDebug.h"
 #include "Utilities/Arrays.h"
 
 
@@ -13,6 +14,8 @@
 DEFINE_LOG_CATEGORY_STATIC(LogImGuiInput, Warning, All);
 #endif
 
+DECLARE_CYCLE_STAT(TEXT("Copy Input"), STAT_ImGui_CopyInput, STATGROUP_ImGui);
+
 namespace
 {
 	//====================================================================================================
@@ -286,6 +289,9 @@ namespace ImGuiInterops
 
 	void CopyInput(ImGuiIO& IO, const FImGuiInputState& InputState)
 	{
+		SCOPE_CYCLE_COUNTER(STAT_ImGui_CopyInput);
+		IMGUI_TRACE_SCOPE("ImGui Copy Input");
+
 		static const uint32 LeftControl = GetKeyIndex(EKeys::LeftControl);
 		static const uint32 RightControl = GetKeyIndex(EKeys::RightControl);
 		static const uint32 LeftShift = GetKeyIndex(EKeys::LeftShift);
@@ -2,6 +2,7 @@
 
 #include "ImGuiModule.h"
 
+#include "ImGuiContextArena.h"
 #include "ImGuiDelegatesContainer.h"
 #include "ImGuiModuleManager.h"
 #include "TextureManager.h"
@@ -98,6 +99,26 @@ void FImGuiModule::ReleaseTexture(const FImGuiTextureHandle& Handle)
 	}
 }
 
+FImGuiTextureHandle FImGuiModule::CreateDynamicTexture(const FName& Name, int32 Width, int32 Height, EPixelFormat Format)
+{
+	const TextureIndex Index = ImGuiModuleManager->GetTextureManager().CreateDynamicTexture(Name, Width, Height, Format);
+	return FImGuiTextureHandle{ Name, ImGuiInterops::ToImTextureID(Index) };
+}
+
+void FImGuiModule::UpdateDynamicTexture(const FImGuiTextureHandle& Handle, const FIntRect& Rect, const uint8* Data, int32 SrcPitch)
+{
+	if (Handle.IsValid())
+	{
+		ImGuiModuleManager->GetTextureManager().UpdateDynamicTexture(ImGuiInterops::ToTextureIndex(Handle.GetTextureId()),
+			Rect, Data, SrcPitch);
+	}
+}
+
+void FImGuiModule::RequestFontGlyphs(const FString& Text)
+{
+	ImGuiModuleManager->GetContextManager().RequestGlyphs(Text);
+}
+
 void FImGuiModule::StartupModule()
 {
 	// Initialize handles to allow cross-module redirections. Other handles will always look for parents in the active
@@ -112,6 +133,9 @@ void FImGuiModule::StartupModule()
 	DelegatesContainerHandle = &FImGuiDelegatesContainer::GetHandle();
 #endif
 
+	// Set allocator before creating managers, so all ImGui memory is allocated and released in the same way.
+	FImGuiContextArena::InstallAllocator();
+
 	// Create managers that implements module logic.
 
 	checkf(!ImGuiModuleManager, TEXT("Instance of the ImGui Module Manager already exists. Instance should be created only during module startup."));
@@ -300,8 +324,10 @@ FImGuiModuleLoader FImGuiModuleLoader::Instance;
 
 bool FImGuiTextureHandle::HasValidEntry() const
 {
-	const TextureIndex Index = ImGuiInterops::ToTextureIndex(TextureId);
-	return Index != INDEX_NONE && ImGuiModuleManager && ImGuiModuleManager->GetTextureManager().GetTextureName(Index) == Name;
+	// Generations encoded in texture indices invalidate handles to released textures until the generation of their
+	// entry wraps around. After that, a stale index can point to a different texture, so names are also compared.
+	return ImGuiModuleManager
+		&& ImGuiModuleManager->GetTextureManager().GetTextureName(ImGuiInterops::ToTextureIndex(TextureId)) == Name;
 }
 
 
@@ -2,7 +2,19 @@
 
 #pragma once
 
+#include "VersionCompatibility.h"
+
 #include <Logging/LogMacros.h>
+#include <Stats/Stats.h>
+
+#if ENGINE_COMPATIBILITY_WITH_LLM
+#include <HAL/LowLevelMemTracker.h>
+#endif
+
+#if ENGINE_COMPATIBILITY_WITH_TRACE_CHANNELS
+#include <ProfilingDebugging/CpuProfilerTrace.h>
+#include <Trace/Trace.h>
+#endif
 
 
 // Module-wide debug symbols and loggers.
@@ -14,3 +26,66 @@
 
 // Input Handler logger (used also in non-developer mode to raise problems with handler extensions).
 DECLARE_LOG_CATEGORY_EXTERN(LogImGuiInputHandler, Warning, All);
+
+// Stats group for module performance counters.
+DECLARE_STATS_GROUP(TEXT("ImGui"), STATGROUP_ImGui, STATCAT_Advanced);
+
+// Memory stats for module allocations (defined in module manager).
+DECLARE_MEMORY_STAT_EXTERN(TEXT("Context Memory"), STAT_ImGui_ContextMemory, STATGROUP_ImGui, );
+DECLARE_MEMORY_STAT_EXTERN(TEXT("Draw Data Memory"), STAT_ImGui_DrawDataMemory, STATGROUP_ImGui, );
+DECLARE_MEMORY_STAT_EXTERN(TEXT("Font Atlas Memory"), STAT_ImGui_FontAtlasMemory, STATGROUP_ImGui, );
+DECLARE_MEMORY_STAT_EXTERN(TEXT("Font Atlas CPU Memory Saved (Alpha8)"), STAT_ImGui_FontAtlasSavedMemory, STATGROUP_ImGui, );
+DECLARE_MEMORY_STAT_EXTERN(TEXT("Texture Memory"), STAT_ImGui_TextureMemory, STATGROUP_ImGui, );
+
+// Low-level memory tracker tags for module allocations (defined in module manager). Engines without module tags track
+// all module allocations under the UI tag.
+#if ENGINE_COMPATIBILITY_WITH_LLM_MODULE_TAGS
+LLM_DECLARE_TAG(ImGui_Context);
+LLM_DECLARE_TAG(ImGui_DrawData);
+LLM_DECLARE_TAG(ImGui_FontAtlas);
+LLM_DECLARE_TAG(ImGui_Textures);
+#define IMGUI_LLM_SCOPE(Tag) LLM_SCOPE_BYTAG(ImGui_##Tag)
+#elif ENGINE_COMPATIBILITY_WITH_LLM
+#define IMGUI_LLM_SCOPE(Tag) LLM_SCOPE(ELLMTag::UI)
+#else
+#define IMGUI_LLM_SCOPE(Tag)
+#endif
+
+// CPU profiler scopes in a dedicated ImGui trace channel (defined in module manager), which can be enabled with
+// -trace=ImGui. Context scopes have the context name appended, so contexts can be told apart in captures.
+#if ENGINE_COMPATIBILITY_WITH_TRACE_CHANNELS
+UE_TRACE_CHANNEL_EXTERN(ImGuiChannel);
+
+// Trace scope with a name built at runtime. Name is only built when the ImGui channel is enabled.
+class FImGuiContextTraceScope
+{
+public:
+
+	FImGuiContextTraceScope(const TCHAR* ScopeName, const FString& ContextName)
+		: bEnabled(UE_TRACE_CHANNELEXPR_IS_ENABLED(ImGuiChannel))
+	{
+		if (bEnabled)
+		{
+			FCpuProfilerTrace::OutputBeginDynamicEvent(*FString::Printf(TEXT("%s [%s]"), ScopeName, *ContextName));
+		}
+	}
+
+	~FImGuiContextTraceScope()
+	{
+		if (bEnabled)
+		{
+			FCpuProfilerTrace::OutputEndEvent();
+		}
+	}
+
+private:
+
+	bool bEnabled;
+};
+
+#define IMGUI_TRACE_SCOPE(Name) TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL_STR(Name, ImGuiChannel)
+#define IMGUI_TRACE_CONTEXT_SCOPE(Name, ContextName) FImGuiContextTraceScope PREPROCESSOR_JOIN(ImGuiContextTraceScope, __LINE__)(TEXT(Name), ContextName)
+#else
+#define IMGUI_TRACE_SCOPE(Name)
+#define IMGUI_TRACE_CONTEXT_SCOPE(Name, ContextName)
+#endif
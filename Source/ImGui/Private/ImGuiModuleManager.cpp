@@ -2,10 +2,17 @@
 
 #include "ImGuiModuleManager.h"
 
+#include "ImGuiContextArena.h"
+#include "ImGuiDelegatesProfiler.h"
 #include "ImGuiInteroperability.h"
+#include "ImGuiModuleDebug.h"
+#include "ImGuiVertexConversion.h"
 #include "Utilities/WorldContextIndex.h"
 
+#include <Engine/Texture2D.h>
 #include <Framework/Application/SlateApplication.h>
+#include <HAL/PlatformTime.h>
+#include <Math/RandomStream.h>
 #include <Modules/ModuleManager.h>
 
 #include <imgui.h>
@@ -18,11 +25,78 @@ constexpr int32 IMGUI_WIDGET_Z_ORDER = 10000;
 const static FName PlainTextureName = "ImGuiModule_Plain";
 const static FName FontAtlasTextureName = "ImGuiModule_FontAtlas";
 
+DEFINE_STAT(STAT_ImGui_ContextMemory);
+DEFINE_STAT(STAT_ImGui_DrawDataMemory);
+DEFINE_STAT(STAT_ImGui_FontAtlasMemory);
+DEFINE_STAT(STAT_ImGui_FontAtlasSavedMemory);
+DEFINE_STAT(STAT_ImGui_TextureMemory);
+
+#if ENGINE_COMPATIBILITY_WITH_TRACE_CHANNELS
+UE_TRACE_CHANNEL_DEFINE(ImGuiChannel);
+#endif
+
+DECLARE_CYCLE_STAT(TEXT("Module Tick"), STAT_ImGui_ModuleTick, STATGROUP_ImGui);
+
+#if ENGINE_COMPATIBILITY_WITH_LLM_MODULE_TAGS
+LLM_DEFINE_TAG(ImGui_Context);
+LLM_DEFINE_TAG(ImGui_DrawData);
+LLM_DEFINE_TAG(ImGui_FontAtlas);
+LLM_DEFINE_TAG(ImGui_Textures);
+#endif
+
+namespace
+{
+	FString FormatBytes(SIZE_T Bytes)
+	{
+		return FString::Printf(TEXT("%.1f KB"), Bytes / 1024.f);
+	}
+
+	// Slate shader used to draw ImGui vertices cannot expand a single channel to white colour, so the texture still needs
+	// RGBA pixels. We expand them to a temporary buffer (the same way as ImGui does it), which is released after the
+	// texture is updated.
+	uint32* ExpandFontAtlasPixels(const ImFontAtlas& Fonts, const FIntRect& Rect)
+	{
+		uint32* Pixels = new uint32[Rect.Width() * Rect.Height()];
+		for (int32 Y = 0; Y < Rect.Height(); Y++)
+		{
+			const unsigned char* AlphaPixels = Fonts.TexPixelsAlpha8 + (Rect.Min.Y + Y) * Fonts.TexWidth + Rect.Min.X;
+			uint32* RowPixels = Pixels + Y * Rect.Width();
+			for (int32 X = 0; X < Rect.Width(); X++)
+			{
+				RowPixels[X] = IM_COL32(255, 255, 255, AlphaPixels[X]);
+			}
+		}
+		return Pixels;
+	}
+
+	void ReleaseFontAtlasPixels(uint8* Data)
+	{
+		delete[] reinterpret_cast<uint32*>(Data);
+	}
+}
+
 FImGuiModuleManager::FImGuiModuleManager()
 	: Commands(Properties)
 	, Settings(Properties, Commands)
 	, ImGuiDemo(Properties)
 	, ContextManager(Settings)
+	, DumpMemoryCommand(TEXT("ImGui.DumpMemory"),
+		TEXT("Print memory used by ImGui contexts and shared resources."),
+		FConsoleCommandWithOutputDeviceDelegate::CreateRaw(this, &FImGuiModuleManager::DumpMemory))
+	, DumpDelegatesProfileCommand(TEXT("ImGui.DumpDelegatesProfile"),
+		TEXT("Print the cost of functions bound to ImGui debug delegates (requires ImGui.ProfileDelegates)."),
+		FConsoleCommandWithOutputDeviceDelegate::CreateRaw(this, &FImGuiModuleManager::DumpDelegatesProfile))
+#if IMGUI_MODULE_DEVELOPER
+	, BenchmarkTexturesCommand(TEXT("ImGui.Debug.BenchmarkTextures"),
+		TEXT("Measure registration, lookup and release of 10k textures in the texture manager."),
+		FConsoleCommandWithOutputDeviceDelegate::CreateRaw(this, &FImGuiModuleManager::BenchmarkTextures))
+	, BenchmarkVertexConversionCommand(TEXT("ImGui.Debug.BenchmarkVertexConversion"),
+		TEXT("Compare speed and output of vectorized vertex conversion with the reference loop."),
+		FConsoleCommandWithOutputDeviceDelegate::CreateRaw(this, &FImGuiModuleManager::BenchmarkVertexConversion))
+	, BenchmarkFrameCommand(TEXT("ImGui.Debug.BenchmarkFrame"),
+		TEXT("Measure ImGui frames drawing the demo window and a long list of widgets in a temporary context."),
+		FConsoleCommandWithOutputDeviceDelegate::CreateRaw(this, &FImGuiModuleManager::BenchmarkFrame))
+#endif
 {
 	// Register in context manager to get information whenever a new context proxy is created.
 	ContextManager.OnContextProxyCreated.AddRaw(this, &FImGuiModuleManager::OnContextProxyCreated);
@@ -47,6 +121,7 @@ FImGuiModuleManager::FImGuiModuleManager()
 FImGuiModuleManager::~FImGuiModuleManager()
 {
 	ContextManager.OnFontAtlasBuilt.RemoveAll(this);
+	ContextManager.OnFontAtlasUpdated.RemoveAll(this);
 
 	// We are no longer interested with adding widgets to viewports.
 	if (ViewportCreatedHandle.IsValid())
@@ -87,8 +162,9 @@ void FImGuiModuleManager::LoadTextures()
 		// Create an empty texture at index 0. We will use it for ImGui outputs with null texture id.
 		TextureManager.CreatePlainTexture(PlainTextureName, 2, 2, FColor::White);
 
-		// Register for atlas built events, so we can rebuild textures.
+		// Register for atlas built and updated events, so we can rebuild or update textures.
 		ContextManager.OnFontAtlasBuilt.AddRaw(this, &FImGuiModuleManager::BuildFontAtlasTexture);
+		ContextManager.OnFontAtlasUpdated.AddRaw(this, &FImGuiModuleManager::UpdateFontAtlasTexture);
 
 		BuildFontAtlasTexture();
 	}
@@ -99,16 +175,31 @@ void FImGuiModuleManager::BuildFontAtlasTexture()
 	// Create a font atlas texture.
 	ImFontAtlas& Fonts = ContextManager.GetFontAtlas();
 
-	unsigned char* Pixels;
-	int Width, Height, Bpp;
-	Fonts.GetTexDataAsRGBA32(&Pixels, &Width, &Height, &Bpp);
+	unsigned char* AlphaPixels;
+	int Width, Height;
+	Fonts.GetTexDataAsAlpha8(&AlphaPixels, &Width, &Height);
 
-	const TextureIndex FontsTexureIndex = TextureManager.CreateTexture(FontAtlasTextureName, Width, Height, Bpp, Pixels);
+	uint32* Pixels = ExpandFontAtlasPixels(Fonts, FIntRect{ 0, 0, Width, Height });
+	const TextureIndex FontsTexureIndex = TextureManager.CreateTexture(FontAtlasTextureName, Width, Height, sizeof(uint32),
+		reinterpret_cast<uint8*>(Pixels), &ReleaseFontAtlasPixels);
 
 	// Set the font texture index in the ImGui.
 	Fonts.TexID = ImGuiInterops::ToImTextureID(FontsTexureIndex);
 }
 
+void FImGuiModuleManager::UpdateFontAtlasTexture(const FIntRect& Rect)
+{
+	// Glyphs added to the atlas only update small rectangles, which are uploaded from transient buffers, so the atlas
+	// texture doesn't need persistent staging memory.
+	const ImFontAtlas& Fonts = ContextManager.GetFontAtlas();
+	if (Fonts.TexPixelsAlpha8 && Rect.Width() > 0 && Rect.Height() > 0)
+	{
+		uint32* Pixels = ExpandFontAtlasPixels(Fonts, Rect);
+		TextureManager.UpdateTexture(ImGuiInterops::ToTextureIndex(Fonts.TexID), Rect, sizeof(uint32),
+			reinterpret_cast<uint8*>(Pixels), &ReleaseFontAtlasPixels);
+	}
+}
+
 void FImGuiModuleManager::RegisterTick()
 {
 	// Slate Post-Tick is a good moment to end and advance ImGui frame as it minimises a tearing.
@@ -164,11 +255,21 @@ void FImGuiModuleManager::Tick(float DeltaSeconds)
 {
 	if (IsInGameThread())
 	{
+		SCOPE_CYCLE_COUNTER(STAT_ImGui_ModuleTick);
+		IMGUI_TRACE_SCOPE("ImGui Module Tick");
+
 		// Update context manager to advance all ImGui contexts to the next frame.
 		ContextManager.Tick(DeltaSeconds);
 
+		// Pack textures that finished streaming and upload updates of dynamic textures, so they are ready before
+		// widgets are painted.
+		TextureManager.UpdateAtlas();
+		TextureManager.FlushDynamicTextures();
+
 		// Inform that we finished updating ImGui, so other subsystems can react.
 		PostImGuiUpdateEvent.Broadcast();
+
+		SET_MEMORY_STAT(STAT_ImGui_TextureMemory, TextureManager.GetTextureMemory());
 	}
 }
 
@@ -231,5 +332,255 @@ void FImGuiModuleManager::AddWidgetsToActiveViewports()
 
 void FImGuiModuleManager::OnContextProxyCreated(int32 ContextIndex, FImGuiContextProxy& ContextProxy)
 {
+	ContextProxy.SetTextureManager(&TextureManager);
 	ContextProxy.OnDraw().AddLambda([this, ContextIndex]() { ImGuiDemo.DrawControls(ContextIndex); });
+	ContextProxy.OnDraw().AddLambda([]() { FImGuiDelegatesProfiler::Get().DrawWindow(); });
+}
+
+void FImGuiModuleManager::DumpDelegatesProfile(FOutputDevice& OutputDevice)
+{
+	FImGuiDelegatesProfiler::Get().Dump(OutputDevice);
+}
+
+void FImGuiModuleManager::DumpMemory(FOutputDevice& OutputDevice)
+{
+	SIZE_T TotalBytes = 0;
+
+	OutputDevice.Logf(TEXT("ImGui memory:"));
+
+	ContextManager.ForEachContextProxy([&](int32 ContextIndex, const FImGuiContextProxy& ContextProxy)
+	{
+		const FImGuiContextProxy::FMemoryStats Stats = ContextProxy.GetMemoryStats();
+		const FImGuiContextArena::FStats ArenaStats = ContextProxy.GetArena().GetStats();
+		OutputDevice.Logf(TEXT("  Context '%s' (%d): Context = %s (allocated %s, peak %s, %u allocations), Draw Data = %s, Paint Buffers = %s, Total = %s"),
+			*ContextProxy.GetName(), ContextIndex, *FormatBytes(Stats.ContextBytes), *FormatBytes(ArenaStats.AllocatedBytes),
+			*FormatBytes(ArenaStats.PeakAllocatedBytes), ArenaStats.NumAllocations, *FormatBytes(Stats.DrawDataBytes),
+			*FormatBytes(Stats.PaintBufferBytes), *FormatBytes(Stats.GetTotalBytes()));
+		TotalBytes += Stats.GetTotalBytes();
+	});
+
+	const SIZE_T FontAtlasBytes = ContextManager.GetFontAtlasMemory();
+	OutputDevice.Logf(TEXT("  Font Atlas (shared): %s (%s of CPU memory saved by Alpha8 pixels)"), *FormatBytes(FontAtlasBytes),
+		*FormatBytes(ContextManager.GetFontAtlasSavedMemory()));
+	TotalBytes += FontAtlasBytes;
+
+	// Alpha8 pixels only save CPU memory. Font atlas texture is still RGBA32, because Slate shader cannot expand
+	// a single channel to white colour, and it is included in textures.
+	int32 NumTextures = 0;
+	const SIZE_T TextureBytes = TextureManager.GetTextureMemory(&NumTextures);
+	OutputDevice.Logf(TEXT("  Textures (shared): %s in %d textures (font atlas texture is RGBA32, no GPU memory saved)"),
+		*FormatBytes(TextureBytes), NumTextures);
+	TotalBytes += TextureBytes;
+
+	OutputDevice.Logf(TEXT("  Total: %s"), *FormatBytes(TotalBytes));
+}
+
+#if IMGUI_MODULE_DEVELOPER
+void FImGuiModuleManager::BenchmarkTextures(FOutputDevice& OutputDevice)
+{
+	constexpr int32 NumTextures = 10000;
+
+	if (!bTexturesLoaded)
+	{
+		OutputDevice.Logf(TEXT("Textures are not loaded yet."));
+		return;
+	}
+
+	// All entries share one texture, so the benchmark measures the manager rather than the texture creation.
+	UTexture2D* Texture = UTexture2D::CreateTransient(2, 2);
+	Texture->AddToRoot();
+
+	TArray<FName> Names;
+	TArray<TextureIndex> Indices;
+	Names.Reserve(NumTextures);
+	Indices.Reserve(NumTextures);
+	for (int32 Index = 0; Index < NumTextures; Index++)
+	{
+		Names.Add(*FString::Printf(TEXT("ImGuiBenchmark_%d"), Index));
+	}
+
+	auto Measure = [&](const TCHAR* Stage, TFunctionRef<void()> Function)
+	{
+		const double StartTime = FPlatformTime::Seconds();
+		Function();
+		OutputDevice.Logf(TEXT("  %s: %.3f ms"), Stage, (FPlatformTime::Seconds() - StartTime) * 1000.0);
+	};
+
+	OutputDevice.Logf(TEXT("ImGui texture manager benchmark (%d textures):"), NumTextures);
+
+	Measure(TEXT("Register"), [&]()
+	{
+		for (const FName& Name : Names)
+		{
+			Indices.Add(TextureManager.CreateTextureResources(Name, Texture));
+		}
+	});
+
+	Measure(TEXT("Find"), [&]()
+	{
+		for (int32 Index = 0; Index < NumTextures; Index++)
+		{
+			checkf(TextureManager.FindTextureIndex(Names[Index]) == Indices[Index], TEXT("Texture lookup failed."));
+		}
+	});
+
+	Measure(TEXT("Release"), [&]()
+	{
+		for (TextureIndex Index : Indices)
+		{
+			TextureManager.ReleaseTextureResources(Index);
+		}
+	});
+
+	// Every registration reuses a released entry, so the resources array does not grow. Entries are reused more times
+	// than they have generations, so this also covers wrapping generations around.
+	Measure(TEXT("Register And Release"), [&]()
+	{
+		for (const FName& Name : Names)
+		{
+			TextureManager.ReleaseTextureResources(TextureManager.CreateTextureResources(Name, Texture));
+		}
+	});
+
+	Texture->RemoveFromRoot();
+}
+
+void FImGuiModuleManager::BenchmarkVertexConversion(FOutputDevice& OutputDevice)
+{
+	constexpr int32 NumVertices = 200000;
+	constexpr int32 NumRuns = 20;
+
+	// Vertices similar to the ones generated for text, with a scaled and translated widget transform.
+	FRandomStream Random(1337);
+	TArray<ImDrawVert> Source;
+	Source.SetNumUninitialized(NumVertices);
+	for (ImDrawVert& Vertex : Source)
+	{
+		Vertex.pos = ImVec2{ Random.FRandRange(0.f, 1920.f), Random.FRandRange(0.f, 1080.f) };
+		Vertex.uv = ImVec2{ Random.GetFraction(), Random.GetFraction() };
+		Vertex.col = static_cast<ImU32>(Random.GetUnsignedInt());
+	}
+
+	const FTransform2D Transform{ FScale2D{ 1.25f, 0.75f }, FVector2D{ 13.3f, -7.1f } };
+
+	// Fields that are not written by the conversion are zeroed, so outputs can be compared as blocks of memory.
+	TArray<FSlateVertex> ReferenceVertices, VectorizedVertices;
+	ReferenceVertices.SetNumZeroed(NumVertices);
+	VectorizedVertices.SetNumZeroed(NumVertices);
+
+	auto Measure = [&](const TCHAR* Stage, TFunctionRef<void()> Function)
+	{
+		// Report the best run, to filter out noise from other threads.
+		double BestTime = MAX_dbl;
+		for (int32 Run = 0; Run < NumRuns; Run++)
+		{
+			const double StartTime = FPlatformTime::Seconds();
+			Function();
+			BestTime = FMath::Min(BestTime, FPlatformTime::Seconds() - StartTime);
+		}
+		OutputDevice.Logf(TEXT("  %s: %.3f ms"), Stage, BestTime * 1000.0);
+	};
+
+	OutputDevice.Logf(TEXT("ImGui vertex conversion benchmark (%d vertices, best of %d runs):"), NumVertices, NumRuns);
+
+	Measure(TEXT("Reference"), [&]()
+	{
+		ImGuiVertexConversion::ConvertVerticesReference(Source.GetData(), ReferenceVertices.GetData(), NumVertices, Transform);
+	});
+
+	Measure(TEXT("Vectorized"), [&]()
+	{
+		ImGuiVertexConversion::ConvertVertices(Source.GetData(), VectorizedVertices.GetData(), NumVertices);
+		ImGuiVertexConversion::TransformPositions(VectorizedVertices.GetData(), NumVertices, Transform);
+	});
+
+	const bool bIdentical = FMemory::Memcmp(ReferenceVertices.GetData(), VectorizedVertices.GetData(),
+		NumVertices * sizeof(FSlateVertex)) == 0;
+	OutputDevice.Logf(TEXT("  Output: %s"), bIdentical ? TEXT("bit-identical") : TEXT("DIFFERENT"));
+}
+
+void FImGuiModuleManager::BenchmarkFrame(FOutputDevice& OutputDevice)
+{
+	constexpr int32 NumWarmUpFrames = 10;
+	constexpr int32 NumFrames = 200;
+
+	// Results depend on how ImGui code accesses the current context, so they should be compared between builds.
+#if WITH_EDITOR && IMGUI_THREAD_LOCAL_CONTEXT
+	const TCHAR* ContextAccess = TEXT("thread-local context through redirecting handle (editor)");
+#elif WITH_EDITOR
+	const TCHAR* ContextAccess = TEXT("module-local context pointer (editor)");
+#elif IMGUI_THREAD_LOCAL_CONTEXT
+	const TCHAR* ContextAccess = TEXT("thread-local context pointer");
+#else
+	const TCHAR* ContextAccess = TEXT("global context pointer");
+#endif
+
+	ImGuiContext* PreviousContext = ImGui::GetCurrentContext();
+
+	// Temporary context uses its own arena and the module font atlas, like contexts created by the context manager.
+	FImGuiContextArena Arena;
+	ImGuiContext* Context = nullptr;
+	{
+		FImGuiContextArena::FScope ArenaScope(Arena);
+		Context = ImGui::CreateContext(&ContextManager.GetFontAtlas());
+	}
+	Arena.BindContext(Context);
+	ImGui::SetCurrentContext(Context);
+
+	ImGuiIO& IO = ImGui::GetIO();
+	IO.IniFilename = nullptr;
+	IO.DisplaySize = ImVec2(1920.f, 1080.f);
+	IO.DeltaTime = 1.f / 60.f;
+
+	auto DrawFrame = []()
+	{
+		constexpr int32 NumListItems = 500;
+
+		ImGui::NewFrame();
+
+		ImGui::ShowDemoWindow();
+
+		ImGui::SetNextWindowPos(ImVec2(700.f, 20.f), ImGuiCond_Always);
+		ImGui::SetNextWindowSize(ImVec2(400.f, 1000.f), ImGuiCond_Always);
+		ImGui::Begin("ImGui Frame Benchmark", nullptr, ImGuiWindowFlags_NoSavedSettings);
+		for (int32 Index = 0; Index < NumListItems; Index++)
+		{
+			ImGui::PushID(Index);
+			ImGui::Text("Item %d", Index);
+			ImGui::SameLine();
+			ImGui::SmallButton("Select");
+			ImGui::PopID();
+		}
+		ImGui::End();
+
+		ImGui::Render();
+	};
+
+	for (int32 Frame = 0; Frame < NumWarmUpFrames; Frame++)
+	{
+		DrawFrame();
+	}
+
+	double TotalTime = 0.0;
+	double BestTime = MAX_dbl;
+	for (int32 Frame = 0; Frame < NumFrames; Frame++)
+	{
+		const double StartTime = FPlatformTime::Seconds();
+		DrawFrame();
+		const double FrameTime = FPlatformTime::Seconds() - StartTime;
+
+		TotalTime += FrameTime;
+		BestTime = FMath::Min(BestTime, FrameTime);
+	}
+
+	OutputDevice.Logf(TEXT("ImGui frame benchmark (%d frames, %s):"), NumFrames, ContextAccess);
+	OutputDevice.Logf(TEXT("  Average: %.3f ms"), TotalTime * 1000.0 / NumFrames);
+	OutputDevice.Logf(TEXT("  Best: %.3f ms"), BestTime * 1000.0);
+	OutputDevice.Logf(TEXT("  Vertices: %d, Indices: %d"), ImGui::GetDrawData()->TotalVtxCount, ImGui::GetDrawData()->TotalIdxCount);
+
+	ImGui::DestroyContext(Context);
+	Arena.UnbindContext();
+
+	ImGui::SetCurrentContext(PreviousContext);
 }
+#endif // IMGUI_MODULE_DEVELOPER
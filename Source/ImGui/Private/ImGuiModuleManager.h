@@ -5,11 +5,14 @@
 #include "ImGuiContextManager.h"
 #include "ImGuiDemo.h"
 #include "ImGuiModuleCommands.h"
+#include "ImGuiModuleDebug.h"
 #include "ImGuiModuleProperties.h"
 #include "ImGuiModuleSettings.h"
 #include "TextureManager.h"
 #include "Widgets/SImGuiLayout.h"
 
+#include <HAL/IConsoleManager.h>
+
 
 // Central manager that implements module logic. It initializes and controls remaining module components.
 class FImGuiModuleManager
@@ -47,6 +50,7 @@ private:
 
 	void LoadTextures();
 	void BuildFontAtlasTexture();
+	void UpdateFontAtlasTexture(const FIntRect& Rect);
 
 	bool IsTickRegistered() { return TickDelegateHandle.IsValid(); }
 	void RegisterTick();
@@ -64,6 +68,15 @@ private:
 
 	void OnContextProxyCreated(int32 ContextIndex, FImGuiContextProxy& ContextProxy);
 
+	void DumpMemory(FOutputDevice& OutputDevice);
+	void DumpDelegatesProfile(FOutputDevice& OutputDevice);
+
+#if IMGUI_MODULE_DEVELOPER
+	void BenchmarkTextures(FOutputDevice& OutputDevice);
+	void BenchmarkVertexConversion(FOutputDevice& OutputDevice);
+	void BenchmarkFrame(FOutputDevice& OutputDevice);
+#endif
+
 	// Event that we call after ImGui is updated.
 	FSimpleMulticastDelegate PostImGuiUpdateEvent;
 
@@ -85,6 +98,23 @@ private:
 	// Manager for textures resources.
 	FTextureManager TextureManager;
 
+	// Command printing memory used by the module.
+	FAutoConsoleCommandWithOutputDevice DumpMemoryCommand;
+
+	// Command printing results of the delegates profiler.
+	FAutoConsoleCommandWithOutputDevice DumpDelegatesProfileCommand;
+
+#if IMGUI_MODULE_DEVELOPER
+	// Command measuring registration, lookup and release of many textures in the texture manager.
+	FAutoConsoleCommandWithOutputDevice BenchmarkTexturesCommand;
+
+	// Command comparing vectorized vertex conversion with the reference loop.
+	FAutoConsoleCommandWithOutputDevice BenchmarkVertexConversionCommand;
+
+	// Command measuring ImGui frames, to compare the cost of accessing the current context in different builds.
+	FAutoConsoleCommandWithOutputDevice BenchmarkFrameCommand;
+#endif
+
 	// Slate widgets that we created.
 	TArray<TWeakPtr<SImGuiLayout>> Widgets;
 
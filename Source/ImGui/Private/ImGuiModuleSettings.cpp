@@ -117,6 +117,8 @@ void FImGuiModuleSettings::UpdateSettings()
 		SetUseSoftwareCursor(SettingsObject->bUseSoftwareCursor);
 		SetToggleInputKey(SettingsObject->ToggleInput);
 		SetCanvasSizeInfo(SettingsObject->CanvasSize);
+		SetUpdateFrequency(SettingsObject->UpdateFrequency);
+		SetGlyphFontFile(SettingsObject->GlyphFontFile.FilePath);
 	}
 }
 
@@ -197,6 +199,24 @@ void FImGuiModuleSettings::SetDPIScaleInfo(const FImGuiDPIScaleInfo& ScaleInfo)
 	OnDPIScaleChangedDelegate.Broadcast(DPIScale);
 }
 
+void FImGuiModuleSettings::SetUpdateFrequency(float Frequency)
+{
+	if (UpdateFrequency != Frequency)
+	{
+		UpdateFrequency = Frequency;
+		OnUpdateFrequencyChanged.Broadcast(UpdateFrequency);
+	}
+}
+
+void FImGuiModuleSettings::SetGlyphFontFile(const FString& Filename)
+{
+	if (GlyphFontFile != Filename)
+	{
+		GlyphFontFile = Filename;
+		OnGlyphFontFileChanged.Broadcast(GlyphFontFile);
+	}
+}
+
 #if WITH_EDITOR
 
 void FImGuiModuleSettings::OnPropertyChanged(class UObject* ObjectBeingModified, struct FPropertyChangedEvent& PropertyChangedEvent)
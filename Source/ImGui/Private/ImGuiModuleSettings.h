@@ -6,6 +6,7 @@
 
 #include <Curves/CurveFloat.h>
 #include <Delegates/Delegate.h>
+#include <Engine/EngineTypes.h>
 #include <InputCoreTypes.h>
 #include <Styling/SlateTypes.h>
 #include <UObject/Object.h>
@@ -218,6 +219,18 @@ protected:
 	UPROPERTY(EditAnywhere, config, Category = "DPI Scale", Meta = (ShowOnlyInnerProperties))
 	FImGuiDPIScaleInfo DPIScale;
 
+	// Target frequency (in Hz) at which ImGui contexts are updated. Between updates, debug delegates are not called and
+	// the last output is presented. Any input forces an immediate update. Zero means that contexts are updated in every
+	// frame. ImGui can still be used outside of debug delegates, but that output is also presented after the next update.
+	UPROPERTY(EditAnywhere, config, Category = "Performance", meta = (ClampMin = 0, UIMin = 0, Units = "Hz"))
+	float UpdateFrequency = 0.f;
+
+	// Font file (TTF or OTF) with glyphs missing in the default font, like CJK characters. Glyphs requested with
+	// FImGuiModule::RequestFontGlyphs are taken from this font and added to the font atlas on demand. Relative paths
+	// are resolved against the project directory.
+	UPROPERTY(EditAnywhere, config, Category = "Fonts")
+	FFilePath GlyphFontFile;
+
 	static UImGuiSettings* DefaultInstance;
 
 	friend class FImGuiModuleSettings;
@@ -236,6 +249,8 @@ public:
 
 	// Generic delegate used to notify changes of boolean properties.
 	DECLARE_MULTICAST_DELEGATE_OneParam(FBoolChangeDelegate, bool);
+	DECLARE_MULTICAST_DELEGATE_OneParam(FFloatChangeDelegate, float);
+	DECLARE_MULTICAST_DELEGATE_OneParam(FStringChangeDelegate, const FString&);
 	DECLARE_MULTICAST_DELEGATE_OneParam(FStringClassReferenceChangeDelegate, const FStringClassReference&);
 	DECLARE_MULTICAST_DELEGATE_OneParam(FImGuiCanvasSizeInfoChangeDelegate, const FImGuiCanvasSizeInfo&);
 	DECLARE_MULTICAST_DELEGATE_OneParam(FImGuiDPIScaleInfoChangeDelegate, const FImGuiDPIScaleInfo&);
@@ -267,6 +282,12 @@ public:
 	// Get the DPI Scale information.
 	const FImGuiDPIScaleInfo& GetDPIScaleInfo() const { return DPIScale; }
 
+	// Get the target frequency at which contexts are updated (zero means every frame).
+	float GetUpdateFrequency() const { return UpdateFrequency; }
+
+	// Get the path to the font file with glyphs added on demand (empty if not set).
+	const FString& GetGlyphFontFile() const { return GlyphFontFile; }
+
 	// Delegate raised when ImGui Input Handle is changed.
 	FStringClassReferenceChangeDelegate OnImGuiInputHandlerClassChanged;
 
@@ -279,6 +300,12 @@ public:
 	// Delegate raised when the DPI scale is changed.
 	FImGuiDPIScaleInfoChangeDelegate OnDPIScaleChangedDelegate;
 
+	// Delegate raised when the target update frequency is changed.
+	FFloatChangeDelegate OnUpdateFrequencyChanged;
+
+	// Delegate raised when the glyph font file is changed.
+	FStringChangeDelegate OnGlyphFontFileChanged;
+
 private:
 
 	void InitializeAllSettings();
@@ -293,6 +320,8 @@ private:
 	void SetToggleInputKey(const FImGuiKeyInfo& KeyInfo);
 	void SetCanvasSizeInfo(const FImGuiCanvasSizeInfo& CanvasSizeInfo);
 	void SetDPIScaleInfo(const FImGuiDPIScaleInfo& ScaleInfo);
+	void SetUpdateFrequency(float Frequency);
+	void SetGlyphFontFile(const FString& Filename);
 
 #if WITH_EDITOR
 	void OnPropertyChanged(class UObject* ObjectBeingModified, struct FPropertyChangedEvent& PropertyChangedEvent);
@@ -305,6 +334,8 @@ private:
 	FImGuiKeyInfo ToggleInputKey;
 	FImGuiCanvasSizeInfo CanvasSize;
 	FImGuiDPIScaleInfo DPIScale;
+	FString GlyphFontFile;
+	float UpdateFrequency = 0.f;
 	bool bShareKeyboardInput = false;
 	bool bShareGamepadInput = false;
 	bool bShareMouseInput = false;
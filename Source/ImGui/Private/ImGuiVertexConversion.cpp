@@ -0,0 +1,283 @@
+// Distributed under the MIT License (MIT) (see accompanying LICENSE file)
+
+#include "ImGuiVertexConversion.h"
+
+#include "ImGuiInteroperability.h"
+
+#include <Math/VectorRegister.h>
+
+
+namespace
+{
+	// Check whether ImU32 colors use the default packing (R in the lowest byte). In that case, conversion to FColor
+	// packed as ARGB is only a matter of swapping red and blue bytes.
+	constexpr bool HasDefaultColorPacking()
+	{
+		return IM_COL32_R_SHIFT == 0 && IM_COL32_G_SHIFT == 8 && IM_COL32_B_SHIFT == 16 && IM_COL32_A_SHIFT == 24;
+	}
+
+	// Check whether ImU32 colors use the same packing as FColor (e.g. after defining IMGUI_USE_BGRA_PACKED_COLOR).
+	constexpr bool HasFColorPacking()
+	{
+		return IM_COL32_R_SHIFT == 16 && IM_COL32_G_SHIFT == 8 && IM_COL32_B_SHIFT == 0 && IM_COL32_A_SHIFT == 24;
+	}
+
+	FORCEINLINE FColor ConvertColor(ImU32 Color)
+	{
+		if (HasDefaultColorPacking())
+		{
+			// Construct from DWORD in ARGB order, which works for both byte orders.
+			return FColor{ (Color & 0xFF00FF00) | ((Color >> 16) & 0xFF) | ((Color & 0xFF) << 16) };
+		}
+		else if (HasFColorPacking())
+		{
+			return FColor{ Color };
+		}
+		else
+		{
+			return ImGuiInterops::UnpackImU32Color(Color);
+		}
+	}
+
+	FORCEINLINE float* GetPosition(FSlateVertex& SlateVertex)
+	{
+#if ENGINE_COMPATIBILITY_LEGACY_CLIPPING_API
+		return SlateVertex.Position;
+#else
+		return &SlateVertex.Position.X;
+#endif // ENGINE_COMPATIBILITY_LEGACY_CLIPPING_API
+	}
+
+	// Vector registers are 128-bit, but Slate vertices store only 64-bit positions followed by other fields. Platform
+	// specific loads and stores move positions of two vertices directly between vertices and register halves.
+#if PLATFORM_ENABLE_VECTORINTRINSICS_NEON
+
+	FORCEINLINE VectorRegister LoadFloat2x2(const float* Low, const float* High)
+	{
+		return vcombine_f32(vld1_f32(Low), vld1_f32(High));
+	}
+
+	FORCEINLINE void StoreFloat2x2(const VectorRegister& Vec, float* Low, float* High)
+	{
+		vst1_f32(Low, vget_low_f32(Vec));
+		vst1_f32(High, vget_high_f32(Vec));
+	}
+
+	FORCEINLINE void StoreFloat2(const VectorRegister& Vec, float* Dst)
+	{
+		vst1_f32(Dst, vget_low_f32(Vec));
+	}
+
+	// Swap red and blue bytes in colors of four vertices (default packing to FColor).
+	FORCEINLINE void ConvertColors4(const ImDrawVert* RESTRICT Src, FSlateVertex* RESTRICT Dst)
+	{
+		uint32x4_t Colors = vdupq_n_u32(Src[0].col);
+		Colors = vsetq_lane_u32(Src[1].col, Colors, 1);
+		Colors = vsetq_lane_u32(Src[2].col, Colors, 2);
+		Colors = vsetq_lane_u32(Src[3].col, Colors, 3);
+
+		const uint32x4_t Swapped = vorrq_u32(vandq_u32(Colors, vdupq_n_u32(0xFF00FF00)),
+			vorrq_u32(vandq_u32(vshrq_n_u32(Colors, 16), vdupq_n_u32(0xFF)), vshlq_n_u32(vandq_u32(Colors, vdupq_n_u32(0xFF)), 16)));
+
+		Dst[0].Color.DWColor() = vgetq_lane_u32(Swapped, 0);
+		Dst[1].Color.DWColor() = vgetq_lane_u32(Swapped, 1);
+		Dst[2].Color.DWColor() = vgetq_lane_u32(Swapped, 2);
+		Dst[3].Color.DWColor() = vgetq_lane_u32(Swapped, 3);
+	}
+
+#elif PLATFORM_ENABLE_VECTORINTRINSICS
+
+	FORCEINLINE VectorRegister LoadFloat2x2(const float* Low, const float* High)
+	{
+		return _mm_loadh_pi(_mm_castpd_ps(_mm_load_sd(reinterpret_cast<const double*>(Low))), reinterpret_cast<const __m64*>(High));
+	}
+
+	FORCEINLINE void StoreFloat2x2(const VectorRegister& Vec, float* Low, float* High)
+	{
+		_mm_storel_pi(reinterpret_cast<__m64*>(Low), Vec);
+		_mm_storeh_pi(reinterpret_cast<__m64*>(High), Vec);
+	}
+
+	FORCEINLINE void StoreFloat2(const VectorRegister& Vec, float* Dst)
+	{
+		_mm_storel_pi(reinterpret_cast<__m64*>(Dst), Vec);
+	}
+
+	// Swap red and blue bytes in colors of four vertices (default packing to FColor).
+	FORCEINLINE void ConvertColors4(const ImDrawVert* RESTRICT Src, FSlateVertex* RESTRICT Dst)
+	{
+		const __m128i Colors = _mm_setr_epi32(static_cast<int32>(Src[0].col), static_cast<int32>(Src[1].col),
+			static_cast<int32>(Src[2].col), static_cast<int32>(Src[3].col));
+
+		const __m128i LowByte = _mm_set1_epi32(0xFF);
+		const __m128i Swapped = _mm_or_si128(_mm_and_si128(Colors, _mm_set1_epi32(static_cast<int32>(0xFF00FF00))),
+			_mm_or_si128(_mm_and_si128(_mm_srli_epi32(Colors, 16), LowByte), _mm_slli_epi32(_mm_and_si128(Colors, LowByte), 16)));
+
+		Dst[0].Color.DWColor() = static_cast<uint32>(_mm_cvtsi128_si32(Swapped));
+		Dst[1].Color.DWColor() = static_cast<uint32>(_mm_cvtsi128_si32(_mm_shuffle_epi32(Swapped, _MM_SHUFFLE(1, 1, 1, 1))));
+		Dst[2].Color.DWColor() = static_cast<uint32>(_mm_cvtsi128_si32(_mm_shuffle_epi32(Swapped, _MM_SHUFFLE(2, 2, 2, 2))));
+		Dst[3].Color.DWColor() = static_cast<uint32>(_mm_cvtsi128_si32(_mm_shuffle_epi32(Swapped, _MM_SHUFFLE(3, 3, 3, 3))));
+	}
+
+#else
+
+	FORCEINLINE VectorRegister LoadFloat2x2(const float* Low, const float* High)
+	{
+		return MakeVectorRegister(Low[0], Low[1], High[0], High[1]);
+	}
+
+	FORCEINLINE void StoreFloat2x2(const VectorRegister& Vec, float* Low, float* High)
+	{
+		Low[0] = Vec.V[0];
+		Low[1] = Vec.V[1];
+		High[0] = Vec.V[2];
+		High[1] = Vec.V[3];
+	}
+
+	FORCEINLINE void StoreFloat2(const VectorRegister& Vec, float* Dst)
+	{
+		Dst[0] = Vec.V[0];
+		Dst[1] = Vec.V[1];
+	}
+
+	// Swap red and blue bytes in colors of four vertices (default packing to FColor).
+	FORCEINLINE void ConvertColors4(const ImDrawVert* RESTRICT Src, FSlateVertex* RESTRICT Dst)
+	{
+		for (int32 Idx = 0; Idx < 4; Idx++)
+		{
+			Dst[Idx].Color = ConvertColor(Src[Idx].col);
+		}
+	}
+
+#endif // PLATFORM_ENABLE_VECTORINTRINSICS_NEON
+
+	// Position and texture coordinates are loaded with a single 128-bit load.
+	static_assert(STRUCT_OFFSET(ImDrawVert, uv) == STRUCT_OFFSET(ImDrawVert, pos) + sizeof(ImVec2),
+		"Vertex conversion expects texture coordinates to directly follow position in ImDrawVert.");
+
+	// Convert position and texture coordinates of a single vertex and update bounds.
+	FORCEINLINE void ConvertPositionAndTexCoords(const ImDrawVert& Src, FSlateVertex& Dst, const VectorRegister& One,
+		VectorRegister& Min, VectorRegister& Max)
+	{
+		// (X, Y, U, V)
+		const VectorRegister PositionAndUV = VectorLoad(&Src.pos.x);
+
+		// Final UV is calculated in shader as XY * ZW, so we need set all components.
+		VectorStore(VectorShuffle(PositionAndUV, One, 2, 3, 0, 1), Dst.TexCoords);
+		StoreFloat2(PositionAndUV, GetPosition(Dst));
+
+		// Only the first two components of bounds are used.
+		Min = VectorMin(Min, PositionAndUV);
+		Max = VectorMax(Max, PositionAndUV);
+	}
+
+	// Transform positions packed as (X0, Y0, X1, Y1). The order of operations is the same as in
+	// FTransform2D::TransformPoint: X * A + Y * C + Tx, X * B + Y * D + Ty. Multiplication and addition are kept separate,
+	// so they are not fused on platforms with FMA instructions.
+	FORCEINLINE VectorRegister TransformFloat2x2(const VectorRegister& Positions, const VectorRegister& AB,
+		const VectorRegister& CD, const VectorRegister& T)
+	{
+		const VectorRegister XX = VectorSwizzle(Positions, 0, 0, 2, 2);
+		const VectorRegister YY = VectorSwizzle(Positions, 1, 1, 3, 3);
+		return VectorAdd(VectorAdd(VectorMultiply(XX, AB), VectorMultiply(YY, CD)), T);
+	}
+}
+
+namespace ImGuiVertexConversion
+{
+	FSlateRect ConvertVertices(const ImDrawVert* RESTRICT Src, FSlateVertex* RESTRICT Dst, uint32 Num)
+	{
+		if (Num == 0)
+		{
+			return FSlateRect{ 0.f, 0.f, 0.f, 0.f };
+		}
+
+		const VectorRegister One = VectorOne();
+		VectorRegister Min = MakeVectorRegister(MAX_flt, MAX_flt, MAX_flt, MAX_flt);
+		VectorRegister Max = MakeVectorRegister(-MAX_flt, -MAX_flt, -MAX_flt, -MAX_flt);
+
+		uint32 Idx = 0;
+		for (; Idx + 3 < Num; Idx += 4)
+		{
+			ConvertPositionAndTexCoords(Src[Idx], Dst[Idx], One, Min, Max);
+			ConvertPositionAndTexCoords(Src[Idx + 1], Dst[Idx + 1], One, Min, Max);
+			ConvertPositionAndTexCoords(Src[Idx + 2], Dst[Idx + 2], One, Min, Max);
+			ConvertPositionAndTexCoords(Src[Idx + 3], Dst[Idx + 3], One, Min, Max);
+
+			if (HasDefaultColorPacking())
+			{
+				ConvertColors4(Src + Idx, Dst + Idx);
+			}
+			else
+			{
+				Dst[Idx].Color = ConvertColor(Src[Idx].col);
+				Dst[Idx + 1].Color = ConvertColor(Src[Idx + 1].col);
+				Dst[Idx + 2].Color = ConvertColor(Src[Idx + 2].col);
+				Dst[Idx + 3].Color = ConvertColor(Src[Idx + 3].col);
+			}
+		}
+
+		for (; Idx < Num; Idx++)
+		{
+			ConvertPositionAndTexCoords(Src[Idx], Dst[Idx], One, Min, Max);
+			Dst[Idx].Color = ConvertColor(Src[Idx].col);
+		}
+
+		return FSlateRect{ VectorGetComponent(Min, 0), VectorGetComponent(Min, 1), VectorGetComponent(Max, 0), VectorGetComponent(Max, 1) };
+	}
+
+	void TransformPositions(FSlateVertex* RESTRICT Vertices, uint32 Num, const FTransform2D& Transform)
+	{
+		float A, B, C, D;
+		Transform.GetMatrix().GetMatrix(A, B, C, D);
+		const FVector2D Translation = Transform.GetTranslation();
+
+		const VectorRegister AB = MakeVectorRegister(A, B, A, B);
+		const VectorRegister CD = MakeVectorRegister(C, D, C, D);
+		const VectorRegister T = MakeVectorRegister((float)Translation.X, (float)Translation.Y, (float)Translation.X, (float)Translation.Y);
+
+		uint32 Idx = 0;
+		for (; Idx + 3 < Num; Idx += 4)
+		{
+			float* P0 = GetPosition(Vertices[Idx]);
+			float* P1 = GetPosition(Vertices[Idx + 1]);
+			float* P2 = GetPosition(Vertices[Idx + 2]);
+			float* P3 = GetPosition(Vertices[Idx + 3]);
+
+			const VectorRegister P01 = LoadFloat2x2(P0, P1);
+			const VectorRegister P23 = LoadFloat2x2(P2, P3);
+
+			StoreFloat2x2(TransformFloat2x2(P01, AB, CD, T), P0, P1);
+			StoreFloat2x2(TransformFloat2x2(P23, AB, CD, T), P2, P3);
+		}
+
+		// Remaining vertices are transformed one by one with the same operations, so results don't depend on position.
+		for (; Idx < Num; Idx++)
+		{
+			float* P = GetPosition(Vertices[Idx]);
+			StoreFloat2(TransformFloat2x2(LoadFloat2x2(P, P), AB, CD, T), P);
+		}
+	}
+
+	void ConvertVerticesReference(const ImDrawVert* Src, FSlateVertex* Dst, uint32 Num, const FTransform2D& Transform)
+	{
+		for (uint32 Idx = 0; Idx < Num; Idx++)
+		{
+			const ImDrawVert& ImGuiVertex = Src[Idx];
+			FSlateVertex& SlateVertex = Dst[Idx];
+
+			// Final UV is calculated in shader as XY * ZW, so we need set all components.
+			SlateVertex.TexCoords[0] = ImGuiVertex.uv.x;
+			SlateVertex.TexCoords[1] = ImGuiVertex.uv.y;
+			SlateVertex.TexCoords[2] = SlateVertex.TexCoords[3] = 1.f;
+
+			const FVector2D VertexPosition = Transform.TransformPoint(ImGuiInterops::ToVector2D(ImGuiVertex.pos));
+			float* Position = GetPosition(SlateVertex);
+			Position[0] = VertexPosition.X;
+			Position[1] = VertexPosition.Y;
+
+			// Unpack ImU32 color.
+			SlateVertex.Color = ImGuiInterops::UnpackImU32Color(ImGuiVertex.col);
+		}
+	}
+}
@@ -0,0 +1,37 @@
+// Distributed under the MIT License (MIT) (see accompanying LICENSE file)
+
+#pragma once
+
+#include "VersionCompatibility.h"
+
+#include <Rendering/RenderingCommon.h>
+
+#include <imgui.h>
+
+
+// Kernels converting ImGui vertices to Slate vertices. They process four vertices per iteration using vector registers
+// that map to SSE or NEON depending on the platform, with the engine's FPU implementation of vector registers as a
+// scalar fallback. Kernels are selected at compile time.
+namespace ImGuiVertexConversion
+{
+	// Convert ImGui vertices to Slate format without transforming positions, which are left in ImGui space.
+	// @param Src - ImGui vertices
+	// @param Dst - Destination for Slate vertices (fields that are not used by the widget are left untouched)
+	// @param Num - Number of vertices to convert
+	// @returns Bounds of converted vertices
+	FSlateRect ConvertVertices(const ImDrawVert* RESTRICT Src, FSlateVertex* RESTRICT Dst, uint32 Num);
+
+	// Transform positions of Slate vertices in place. Results are bit-identical with FTransform2D::TransformPoint.
+	// @param Vertices - Slate vertices to transform
+	// @param Num - Number of vertices to transform
+	// @param Transform - Transform to apply to positions
+	void TransformPositions(FSlateVertex* RESTRICT Vertices, uint32 Num, const FTransform2D& Transform);
+
+	// Convert and transform vertices one at a time. This is the original conversion loop, kept as a reference for
+	// validating and benchmarking the vectorized kernels.
+	// @param Src - ImGui vertices
+	// @param Dst - Destination for Slate vertices (fields that are not used by the widget are left untouched)
+	// @param Num - Number of vertices to convert
+	// @param Transform - Transform to apply to positions
+	void ConvertVerticesReference(const ImDrawVert* Src, FSlateVertex* Dst, uint32 Num, const FTransform2D& Transform);
+}
@@ -0,0 +1,218 @@
+// Distributed under the MIT License (MIT) (see accompanying LICENSE file)
+
+#include "ImGuiContextManager.h"
+#include "ImGuiContextProxy.h"
+#include "Utilities/WorldContextIndex.h"
+
+#include <HAL/IConsoleManager.h>
+#include <Misc/AutomationTest.h>
+#include <Templates/UniquePtr.h>
+
+#include <imgui.h>
+
+
+// Parallel tick is only available when contexts are thread-local.
+#if WITH_DEV_AUTOMATION_TESTS && IMGUI_THREAD_LOCAL_CONTEXT
+
+namespace
+{
+	constexpr int32 NumContexts = 6;
+	constexpr int32 NumFrames = 4;
+	constexpr float DeltaSeconds = 1.f / 60.f;
+
+	// Draw content that is different for every context and frame, but that doesn't depend on anything else.
+	void DrawTestContent(FImGuiContextProxy& Proxy, int32 ContextNb, int32 FrameNb)
+	{
+		Proxy.SetAsCurrent();
+
+		static const char* WindowNames[] = { "Test Window 0", "Test Window 1", "Test Window 2" };
+
+		for (int32 WindowNb = 0; WindowNb <= ContextNb % 3; WindowNb++)
+		{
+			ImGui::SetNextWindowPos(ImVec2(20.f + 150.f * WindowNb, 20.f + 10.f * ContextNb), ImGuiCond_Always);
+			ImGui::SetNextWindowSize(ImVec2(140.f, 200.f), ImGuiCond_Always);
+			ImGui::Begin(WindowNames[WindowNb], nullptr, ImGuiWindowFlags_NoSavedSettings);
+
+			ImGui::Text("Context %d, frame %d", ContextNb, FrameNb);
+			ImGui::Button("Button");
+			for (int32 LineNb = 0; LineNb < ContextNb + FrameNb; LineNb++)
+			{
+				ImGui::BulletText("Line %d", LineNb);
+			}
+
+			ImDrawList* DrawList = ImGui::GetWindowDrawList();
+			const ImVec2 Cursor = ImGui::GetCursorScreenPos();
+			DrawList->AddCircleFilled(ImVec2(Cursor.x + 20.f, Cursor.y + 20.f), 10.f + FrameNb, IM_COL32(255, 32 * ContextNb, 0, 255));
+
+			ImGui::End();
+		}
+	}
+
+	TArray<TUniquePtr<FImGuiContextProxy>> CreateProxies(ImFontAtlas& FontAtlas, const TCHAR* Mode)
+	{
+		TArray<TUniquePtr<FImGuiContextProxy>> Proxies;
+		for (int32 ContextNb = 0; ContextNb < NumContexts; ContextNb++)
+		{
+			Proxies.Emplace(new FImGuiContextProxy(FString::Printf(TEXT("TickTest%s%d"), Mode, ContextNb),
+				Utilities::INVALID_CONTEXT_INDEX, &FontAtlas, 1.f));
+
+			// Test contexts should not read or write session data.
+			Proxies.Last()->SetAsCurrent();
+			ImGui::GetIO().IniFilename = nullptr;
+		}
+		return Proxies;
+	}
+
+	// Copy the data of all draw commands in the way they are copied by widgets.
+	void CopyDrawData(const FImGuiContextProxy& Proxy, TArray<FSlateVertex>& OutVertices, TArray<SlateIndex>& OutIndices,
+		TArray<FImGuiDrawCommand>& OutCommands)
+	{
+		const FTransform2D Transform;
+
+#if ENGINE_COMPATIBILITY_LEGACY_CLIPPING_API
+		const FSlateRotatedRect VertexClippingRect{ FSlateRect{ 0.f, 0.f, 4096.f, 4096.f } };
+#endif
+
+		TArray<FSlateVertex> VertexBuffer;
+		TArray<SlateIndex> IndexBuffer;
+
+		for (const FImGuiDrawList& DrawList : Proxy.GetDrawData())
+		{
+			for (int32 CommandNb = 0; CommandNb < DrawList.NumCommands(); CommandNb++)
+			{
+				const FImGuiDrawCommand Command = DrawList.GetCommand(CommandNb, Transform);
+				OutCommands.Add(Command);
+
+#if ENGINE_COMPATIBILITY_LEGACY_CLIPPING_API
+				DrawList.CopyVertexData(VertexBuffer, Transform, VertexClippingRect, Command);
+#else
+				DrawList.CopyVertexData(VertexBuffer, Transform, Command);
+#endif
+				DrawList.CopyIndexData(IndexBuffer, Command);
+
+				OutVertices.Append(VertexBuffer);
+				OutIndices.Append(IndexBuffer);
+			}
+		}
+	}
+
+	bool IsSameVertex(const FSlateVertex& A, const FSlateVertex& B)
+	{
+		// Only fields written by the conversion are compared.
+		return A.Position == B.Position && A.TexCoords[0] == B.TexCoords[0] && A.TexCoords[1] == B.TexCoords[1]
+			&& A.Color == B.Color;
+	}
+
+	bool IsSameCommand(const FImGuiDrawCommand& A, const FImGuiDrawCommand& B)
+	{
+		return A.NumElements == B.NumElements && A.ClippingRect == B.ClippingRect && A.TextureId == B.TextureId
+			&& A.IndexOffset == B.IndexOffset && A.VertexOffset == B.VertexOffset && A.NumVertices == B.NumVertices;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FImGuiContextTickTest, "ImGui.Context.ParallelTick",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FImGuiContextTickTest::RunTest(const FString& Parameters)
+{
+	ImGuiContext* PreviousContext = ImGui::GetCurrentContext();
+
+	// Frame budget can defer debug delegates differently in both modes, so it is disabled for the test.
+	IConsoleVariable* DebugFrameBudget = IConsoleManager::Get().FindConsoleVariable(TEXT("ImGui.DebugFrameBudget"));
+	const float PreviousDebugFrameBudget = DebugFrameBudget ? DebugFrameBudget->GetFloat() : 0.f;
+	if (DebugFrameBudget)
+	{
+		DebugFrameBudget->Set(0.f, ECVF_SetByCode);
+	}
+
+	ImFontAtlas FontAtlas;
+	FontAtlas.AddFontDefault();
+	FontAtlas.Build();
+
+	TArray<TUniquePtr<FImGuiContextProxy>> SerialProxies = CreateProxies(FontAtlas, TEXT("Serial"));
+	TArray<TUniquePtr<FImGuiContextProxy>> ParallelProxies = CreateProxies(FontAtlas, TEXT("Parallel"));
+
+	TArray<FImGuiContextProxy*> ParallelProxyPointers;
+	for (const auto& Proxy : ParallelProxies)
+	{
+		ParallelProxyPointers.Add(Proxy.Get());
+	}
+
+	{
+		// Contexts tick once per engine frame, so frames are advanced here and the frame number is restored at the end.
+		TGuardValue<uint32> FrameNumberGuard(GFrameNumber, GFrameNumber);
+
+		for (int32 FrameNb = 0; FrameNb < NumFrames; FrameNb++)
+		{
+			GFrameNumber++;
+
+			for (int32 ContextNb = 0; ContextNb < NumContexts; ContextNb++)
+			{
+				DrawTestContent(*SerialProxies[ContextNb], ContextNb, FrameNb);
+				SerialProxies[ContextNb]->Tick(DeltaSeconds);
+			}
+
+			for (int32 ContextNb = 0; ContextNb < NumContexts; ContextNb++)
+			{
+				DrawTestContent(*ParallelProxies[ContextNb], ContextNb, FrameNb);
+			}
+
+			FImGuiContextManager::TickInParallel(ParallelProxyPointers, DeltaSeconds);
+
+			for (int32 ContextNb = 0; ContextNb < NumContexts; ContextNb++)
+			{
+				TArray<FSlateVertex> SerialVertices, ParallelVertices;
+				TArray<SlateIndex> SerialIndices, ParallelIndices;
+				TArray<FImGuiDrawCommand> SerialCommands, ParallelCommands;
+
+				CopyDrawData(*SerialProxies[ContextNb], SerialVertices, SerialIndices, SerialCommands);
+				CopyDrawData(*ParallelProxies[ContextNb], ParallelVertices, ParallelIndices, ParallelCommands);
+
+				const FString Context = FString::Printf(TEXT("context %d, frame %d"), ContextNb, FrameNb);
+
+				TestTrue(FString::Printf(TEXT("Context has draw data (%s)"), *Context), SerialCommands.Num() > 0);
+
+				TestEqual(FString::Printf(TEXT("Number of draw commands (%s)"), *Context), ParallelCommands.Num(), SerialCommands.Num());
+				TestEqual(FString::Printf(TEXT("Number of vertices (%s)"), *Context), ParallelVertices.Num(), SerialVertices.Num());
+				TestEqual(FString::Printf(TEXT("Number of indices (%s)"), *Context), ParallelIndices.Num(), SerialIndices.Num());
+
+				if (ParallelCommands.Num() != SerialCommands.Num() || ParallelVertices.Num() != SerialVertices.Num()
+					|| ParallelIndices.Num() != SerialIndices.Num())
+				{
+					continue;
+				}
+
+				bool bSameCommands = true;
+				for (int32 Index = 0; Index < SerialCommands.Num() && bSameCommands; Index++)
+				{
+					bSameCommands = IsSameCommand(SerialCommands[Index], ParallelCommands[Index]);
+				}
+
+				bool bSameVertices = true;
+				for (int32 Index = 0; Index < SerialVertices.Num() && bSameVertices; Index++)
+				{
+					bSameVertices = IsSameVertex(SerialVertices[Index], ParallelVertices[Index]);
+				}
+
+				TestTrue(FString::Printf(TEXT("Same draw commands (%s)"), *Context), bSameCommands);
+				TestTrue(FString::Printf(TEXT("Same vertices (%s)"), *Context), bSameVertices);
+				TestTrue(FString::Printf(TEXT("Same indices (%s)"), *Context),
+					FMemory::Memcmp(SerialIndices.GetData(), ParallelIndices.GetData(), SerialIndices.Num() * sizeof(SlateIndex)) == 0);
+			}
+		}
+	}
+
+	SerialProxies.Empty();
+	ParallelProxies.Empty();
+
+	ImGui::SetCurrentContext(PreviousContext);
+
+	if (DebugFrameBudget)
+	{
+		DebugFrameBudget->Set(PreviousDebugFrameBudget, ECVF_SetByCode);
+	}
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS && IMGUI_THREAD_LOCAL_CONTEXT
@@ -0,0 +1,182 @@
+// Distributed under the MIT License (MIT) (see accompanying LICENSE file)
+
+#include "ImGuiDrawData.h"
+#include "ImGuiInteroperability.h"
+#include "TextureManager.h"
+#include "VersionCompatibility.h"
+
+#include <Engine/Texture2D.h>
+#include <Framework/Application/SlateApplication.h>
+#include <HAL/IConsoleManager.h>
+#include <Misc/AutomationTest.h>
+#include <RenderingThread.h>
+
+#include <imgui.h>
+
+
+// Textures are only packed into atlas pages in engine versions that can copy textures with RHI.
+#if WITH_DEV_AUTOMATION_TESTS && ENGINE_COMPATIBILITY_WITH_RHI_COPY_TEXTURE
+
+namespace
+{
+	constexpr int32 ImageSize = 16;
+
+	// Draw an image in the first column and text in the second column, in a few rows. Columns draw to separate channels,
+	// so commands of each column reference vertices interleaved with vertices of the other column.
+	void DrawColumns(ImTextureID Image)
+	{
+		ImGui::SetNextWindowPos(ImVec2(10.f, 10.f), ImGuiCond_Always);
+		ImGui::SetNextWindowSize(ImVec2(300.f, 200.f), ImGuiCond_Always);
+		ImGui::Begin("Draw Data Test", nullptr, ImGuiWindowFlags_NoSavedSettings);
+
+		ImGui::Columns(2, "Columns");
+		for (int32 RowNb = 0; RowNb < 3; RowNb++)
+		{
+			ImGui::Image(Image, ImVec2(ImageSize, ImageSize));
+			ImGui::NextColumn();
+			ImGui::Text("Row %d", RowNb);
+			ImGui::NextColumn();
+		}
+		ImGui::Columns(1);
+
+		ImGui::End();
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FImGuiDrawDataAtlasColumnsTest, "ImGui.DrawData.AtlasTexCoordsInColumns",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FImGuiDrawDataAtlasColumnsTest::RunTest(const FString& Parameters)
+{
+	// Texture manager needs Slate renderer to create resource handles.
+	if (!FSlateApplication::IsInitialized())
+	{
+		AddWarning(TEXT("Slate is not initialized, so textures cannot be registered."));
+		return true;
+	}
+
+	IConsoleVariable* AtlasMaxSize = IConsoleManager::Get().FindConsoleVariable(TEXT("ImGui.TextureAtlas.MaxSize"));
+	if (!AtlasMaxSize)
+	{
+		AddError(TEXT("Texture atlas CVar not found."));
+		return false;
+	}
+
+	const int32 PreviousAtlasMaxSize = AtlasMaxSize->GetInt();
+	AtlasMaxSize->Set(ImageSize, ECVF_SetByCode);
+
+	FTextureManager TextureManager;
+
+	// Texture is not owned by the manager, so it is kept in the root set until the end of the test.
+	UTexture2D* Texture = UTexture2D::CreateTransient(ImageSize, ImageSize);
+	Texture->AddToRoot();
+	Texture->UpdateResource();
+	FlushRenderingCommands();
+
+	const TextureIndex ImageIndex = TextureManager.CreateTextureResources(TEXT("ImGuiDrawDataTest_Image"), Texture);
+
+	AtlasMaxSize->Set(PreviousAtlasMaxSize, ECVF_SetByCode);
+
+	TextureIndex PageIndex;
+	FVector2D UVOffset, UVScale;
+	if (!TextureManager.GetAtlasPlacement(ImageIndex, PageIndex, UVOffset, UVScale))
+	{
+		AddError(TEXT("Test texture was not packed into an atlas page."));
+		Texture->RemoveFromRoot();
+		return false;
+	}
+
+	ImGuiContext* PreviousContext = ImGui::GetCurrentContext();
+
+	ImFontAtlas FontAtlas;
+	FontAtlas.AddFontDefault();
+	FontAtlas.Build();
+
+	ImGuiContext* Context = ImGui::CreateContext(&FontAtlas);
+	ImGui::SetCurrentContext(Context);
+
+	ImGuiIO& IO = ImGui::GetIO();
+	IO.IniFilename = nullptr;
+	IO.DisplaySize = ImVec2(800.f, 600.f);
+	IO.DeltaTime = 1.f / 60.f;
+
+	ImGui::NewFrame();
+	DrawColumns(ImGuiInterops::ToImTextureID(ImageIndex));
+	ImGui::Render();
+
+	const ImDrawData* DrawData = ImGui::GetDrawData();
+	const FTransform2D Transform;
+
+#if ENGINE_COMPATIBILITY_LEGACY_CLIPPING_API
+	const FSlateRotatedRect VertexClippingRect{ FSlateRect{ 0.f, 0.f, 4096.f, 4096.f } };
+#endif
+
+	int32 NumImageCommands = 0;
+	int32 NumOtherCommands = 0;
+
+	for (int32 ListNb = 0; ListNb < DrawData->CmdListsCount; ListNb++)
+	{
+		ImDrawList& Source = *DrawData->CmdLists[ListNb];
+
+		// Source data are moved to the converted list, so the expected data are copied before.
+		TArray<ImDrawCmd> SourceCommands(Source.CmdBuffer.Data, Source.CmdBuffer.Size);
+		TArray<ImDrawIdx> SourceIndices(Source.IdxBuffer.Data, Source.IdxBuffer.Size);
+		TArray<ImDrawVert> SourceVertices(Source.VtxBuffer.Data, Source.VtxBuffer.Size);
+
+		FImGuiDrawList DrawList;
+		DrawList.TransferDrawData(Source, FImGuiDrawList::CalculateContentHash(Source));
+		DrawList.ConvertDrawData(&TextureManager);
+
+		TArray<FSlateVertex> VertexBuffer;
+		TArray<SlateIndex> IndexBuffer;
+
+		for (int32 CommandNb = 0; CommandNb < DrawList.NumCommands(); CommandNb++)
+		{
+			const ImDrawCmd& SourceCommand = SourceCommands[CommandNb];
+			const FImGuiDrawCommand Command = DrawList.GetCommand(CommandNb, Transform);
+
+			const bool bIsImage = ImGuiInterops::ToTextureIndex(SourceCommand.TextureId) == ImageIndex;
+			(bIsImage ? NumImageCommands : NumOtherCommands)++;
+
+			if (bIsImage)
+			{
+				TestEqual(TEXT("Image command is drawn with the atlas page"), Command.TextureId, PageIndex);
+			}
+
+#if ENGINE_COMPATIBILITY_LEGACY_CLIPPING_API
+			DrawList.CopyVertexData(VertexBuffer, Transform, VertexClippingRect, Command);
+#else
+			DrawList.CopyVertexData(VertexBuffer, Transform, Command);
+#endif
+			DrawList.CopyIndexData(IndexBuffer, Command);
+
+			bool bExpectedTexCoords = IndexBuffer.Num() == static_cast<int32>(SourceCommand.ElemCount);
+			for (uint32 ElementNb = 0; ElementNb < SourceCommand.ElemCount && bExpectedTexCoords; ElementNb++)
+			{
+				const ImDrawVert& SourceVertex = SourceVertices[SourceCommand.VtxOffset + SourceIndices[SourceCommand.IdxOffset + ElementNb]];
+				const FVector2D SourceUV{ SourceVertex.uv.x, SourceVertex.uv.y };
+				const FVector2D ExpectedUV = bIsImage ? UVOffset + SourceUV * UVScale : SourceUV;
+
+				const FSlateVertex& Vertex = VertexBuffer[IndexBuffer[ElementNb]];
+				bExpectedTexCoords = FMath::IsNearlyEqual(Vertex.TexCoords[0], ExpectedUV.X, KINDA_SMALL_NUMBER)
+					&& FMath::IsNearlyEqual(Vertex.TexCoords[1], ExpectedUV.Y, KINDA_SMALL_NUMBER);
+			}
+
+			TestTrue(FString::Printf(TEXT("Texture coordinates of %s command %d in list %d"),
+				bIsImage ? TEXT("image") : TEXT("non-image"), CommandNb, ListNb), bExpectedTexCoords);
+		}
+	}
+
+	TestTrue(TEXT("Image is drawn"), NumImageCommands > 0);
+	TestTrue(TEXT("Text is drawn"), NumOtherCommands > 0);
+
+	ImGui::DestroyContext(Context);
+	ImGui::SetCurrentContext(PreviousContext);
+
+	TextureManager.ReleaseTextureResources(ImageIndex);
+	Texture->RemoveFromRoot();
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS && ENGINE_COMPATIBILITY_WITH_RHI_COPY_TEXTURE
@@ -0,0 +1,67 @@
+// Distributed under the MIT License (MIT) (see accompanying LICENSE file)
+
+#include "ImGuiVertexConversion.h"
+
+#include <Math/RandomStream.h>
+#include <Misc/AutomationTest.h>
+
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FImGuiVertexConversionTest, "ImGui.DrawData.VertexConversion",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FImGuiVertexConversionTest::RunTest(const FString& Parameters)
+{
+	// Odd number of vertices, so the remainder loops are also tested.
+	constexpr int32 NumVertices = 1027;
+
+	FRandomStream Random(1337);
+	TArray<ImDrawVert> Source;
+	Source.SetNumUninitialized(NumVertices);
+	for (ImDrawVert& Vertex : Source)
+	{
+		Vertex.pos = ImVec2{ Random.FRandRange(-100.f, 2000.f), Random.FRandRange(-100.f, 2000.f) };
+		Vertex.uv = ImVec2{ Random.GetFraction(), Random.GetFraction() };
+		Vertex.col = static_cast<ImU32>(Random.GetUnsignedInt());
+	}
+
+	const FTransform2D Transforms[] =
+	{
+		FTransform2D{},
+		FTransform2D{ FVector2D{ 13.3f, -7.1f } },
+		FTransform2D{ FScale2D{ 1.25f, 0.75f }, FVector2D{ 0.5f, 1024.25f } },
+		FTransform2D{ FQuat2D{ 0.3f } }.Concatenate(FTransform2D{ FVector2D{ -3.f, 17.7f } })
+	};
+
+	for (const FTransform2D& Transform : Transforms)
+	{
+		// Fields that are not written by the conversion are zeroed, so outputs can be compared as blocks of memory.
+		TArray<FSlateVertex> ReferenceVertices, VectorizedVertices;
+		ReferenceVertices.SetNumZeroed(NumVertices);
+		VectorizedVertices.SetNumZeroed(NumVertices);
+
+		ImGuiVertexConversion::ConvertVerticesReference(Source.GetData(), ReferenceVertices.GetData(), NumVertices, Transform);
+
+		const FSlateRect Bounds = ImGuiVertexConversion::ConvertVertices(Source.GetData(), VectorizedVertices.GetData(), NumVertices);
+		ImGuiVertexConversion::TransformPositions(VectorizedVertices.GetData(), NumVertices, Transform);
+
+		TestTrue(TEXT("Vectorized conversion is bit-identical with the reference loop"),
+			FMemory::Memcmp(ReferenceVertices.GetData(), VectorizedVertices.GetData(), NumVertices * sizeof(FSlateVertex)) == 0);
+
+		FSlateRect ExpectedBounds{ MAX_flt, MAX_flt, -MAX_flt, -MAX_flt };
+		for (const ImDrawVert& Vertex : Source)
+		{
+			ExpectedBounds.Left = FMath::Min(ExpectedBounds.Left, Vertex.pos.x);
+			ExpectedBounds.Top = FMath::Min(ExpectedBounds.Top, Vertex.pos.y);
+			ExpectedBounds.Right = FMath::Max(ExpectedBounds.Right, Vertex.pos.x);
+			ExpectedBounds.Bottom = FMath::Max(ExpectedBounds.Bottom, Vertex.pos.y);
+		}
+
+		TestTrue(TEXT("Bounds match all converted vertices"), Bounds == ExpectedBounds);
+	}
+
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -2,12 +2,27 @@
 
 #include "TextureManager.h"
 
+#include "ImGuiModuleDebug.h"
+#include "VersionCompatibility.h"
+
 #include <Engine/Texture2D.h>
 #include <Framework/Application/SlateApplication.h>
+#include <HAL/IConsoleManager.h>
+#include <RenderingThread.h>
+#include <RHICommandList.h>
 
 #include <algorithm>
 
 
+namespace CVars
+{
+	TAutoConsoleVariable<int> TextureAtlasMaxSize(TEXT("ImGui.TextureAtlas.MaxSize"), 0,
+		TEXT("Maximum width and height of registered textures that are packed into shared atlas pages, so they can be\n")
+		TEXT("drawn together with other textures. Textures are copied when registered. Zero disables atlasing (default)."),
+		ECVF_Default);
+}
+
+
 void FTextureManager::InitializeErrorTexture(const FColor& Color)
 {
 	CreatePlainTextureInternal(NAME_ErrorTexture, 2, 2, Color);
@@ -20,6 +35,27 @@ TextureIndex FTextureManager::CreateTexture(const FName& Name, int32 Width, int3
 	return CreateTextureInternal(Name, Width, Height, SrcBpp, SrcData, SrcDataCleanup);
 }
 
+void FTextureManager::UpdateTexture(TextureIndex Index, const FIntRect& Rect, uint32 SrcBpp, uint8* SrcData, TFunction<void(uint8*)> SrcDataCleanup)
+{
+	UTexture2D* Texture = IsValidTexture(Index) ? TextureResources[GetEntryIndex(Index)].GetOwnedTexture() : nullptr;
+	if (!Texture || Rect.Width() <= 0 || Rect.Height() <= 0)
+	{
+		SrcDataCleanup(SrcData);
+		return;
+	}
+
+	checkf(Rect.Min.X >= 0 && Rect.Min.Y >= 0 && Rect.Max.X <= Texture->GetSizeX() && Rect.Max.Y <= Texture->GetSizeY(),
+		TEXT("Updated rectangle is outside of the texture."));
+
+	FUpdateTextureRegion2D* TextureRegion = new FUpdateTextureRegion2D(Rect.Min.X, Rect.Min.Y, 0, 0, Rect.Width(), Rect.Height());
+	auto DataCleanup = [SrcDataCleanup](uint8* Data, const FUpdateTextureRegion2D* UpdateRegion)
+	{
+		SrcDataCleanup(Data);
+		delete UpdateRegion;
+	};
+	Texture->UpdateTextureRegions(0, 1u, TextureRegion, SrcBpp * Rect.Width(), SrcBpp, SrcData, DataCleanup);
+}
+
 TextureIndex FTextureManager::CreatePlainTexture(const FName& Name, int32 Width, int32 Height, FColor Color)
 {
 	checkf(Name != NAME_None, TEXT("Trying to create a texture with a name 'NAME_None' is not allowed."));
@@ -33,18 +69,158 @@ TextureIndex FTextureManager::CreateTextureResources(const FName& Name, UTexture
 	checkf(Texture, TEXT("Null Texture."));
 
 	// Create an entry for the texture.
-	return AddTextureEntry(Name, Texture, false);
+	const TextureIndex Index = AddTextureEntry(Name, Texture, false);
+
+	AddToAtlas(Index, Texture);
+
+	return Index;
+}
+
+TextureIndex FTextureManager::CreateDynamicTexture(const FName& Name, int32 Width, int32 Height, EPixelFormat Format)
+{
+	checkf(Name != NAME_None, TEXT("Trying to create a texture with a name 'NAME_None' is not allowed."));
+	checkf(Width > 0 && Height > 0, TEXT("Invalid dynamic texture size %dx%d."), Width, Height);
+
+	IMGUI_LLM_SCOPE(Textures);
+
+	UTexture2D* Texture = UTexture2D::CreateTransient(Width, Height, Format);
+
+	// Start from zeroed memory, matching the content of staging buffers.
+	FTexture2DMipMap& Mip = Texture->PlatformData->Mips[0];
+	FMemory::Memzero(Mip.BulkData.Lock(LOCK_READ_WRITE), Mip.BulkData.GetBulkDataSize());
+	Mip.BulkData.Unlock();
+
+	Texture->UpdateResource();
+
+	const TextureIndex Index = AddTextureEntry(Name, Texture, true);
+	DynamicTextures.Add(Index, MakeUnique<FDynamicTexture>(Texture, Width, Height, Format));
+	return Index;
+}
+
+void FTextureManager::UpdateDynamicTexture(TextureIndex Index, const FIntRect& Rect, const uint8* Data, int32 SrcPitch)
+{
+	if (TUniquePtr<FDynamicTexture>* DynamicTexture = DynamicTextures.Find(Index))
+	{
+		(*DynamicTexture)->Update(Rect, Data, SrcPitch);
+	}
+}
+
+void FTextureManager::FlushDynamicTextures()
+{
+	for (auto& Pair : DynamicTextures)
+	{
+		Pair.Value->Flush();
+	}
+}
+
+void FTextureManager::UpdateAtlas()
+{
+	for (int32 Nb = PendingAtlasTextures.Num() - 1; Nb >= 0; Nb--)
+	{
+		const TextureIndex Index = PendingAtlasTextures[Nb].Key;
+		UTexture2D* Texture = PendingAtlasTextures[Nb].Value.Get();
+		PendingAtlasTextures.RemoveAtSwap(Nb, 1, false);
+
+		// Queued again, if the texture is still not streamed in.
+		if (Texture && IsValidTexture(Index))
+		{
+			AddToAtlas(Index, Texture);
+		}
+	}
 }
 
 void FTextureManager::ReleaseTextureResources(TextureIndex Index)
 {
-	checkf(IsInRange(Index), TEXT("Invalid texture index %d. Texture resources array has %d entries total."), Index, TextureResources.Num());
+	const int32 EntryIndex = GetEntryIndex(Index);
+	checkf(Index >= 0 && IsInRange(EntryIndex), TEXT("Invalid texture index %d. Texture resources array has %d entries total."),
+		Index, TextureResources.Num());
 
-	TextureResources[Index] = {};
+	// Releasing a texture that was already released would add its entry to the free list twice or release a texture
+	// that reused the entry.
+	if (IsValidTexture(Index))
+	{
+		RemoveFromAtlas(EntryIndex);
+		DynamicTextures.Remove(Index);
+
+#if ENGINE_COMPATIBILITY_WITH_RHI_COPY_TEXTURE
+		PendingAtlasTextures.RemoveAllSwap([Index](const TPair<TextureIndex, TWeakObjectPtr<UTexture2D>>& Pending)
+		{
+			return Pending.Key == Index;
+		});
+#endif
+
+		FTextureEntry& Entry = TextureResources[EntryIndex];
+		NameToIndex.Remove(Entry.GetName());
+
+		// New generation invalidates all indices to this entry.
+		Entry = {};
+		Entry.Generation = (Entry.Generation + 1) & MaxGeneration;
+
+		if (Entry.Generation != 0)
+		{
+			Entry.NextFreeIndex = FirstFreeIndex;
+			FirstFreeIndex = EntryIndex;
+
+			if (LastFreeIndex == INDEX_NONE)
+			{
+				LastFreeIndex = EntryIndex;
+			}
+		}
+		else
+		{
+			// Entries with wrapped generations are reused after all other released entries, which makes it less
+			// likely that a stale index still exists when its generation repeats.
+			if (LastFreeIndex != INDEX_NONE)
+			{
+				TextureResources[LastFreeIndex].NextFreeIndex = EntryIndex;
+			}
+			else
+			{
+				FirstFreeIndex = EntryIndex;
+			}
+
+			LastFreeIndex = EntryIndex;
+		}
+	}
+}
+
+SIZE_T FTextureManager::GetTextureMemory(int32* OutNumTextures) const
+{
+	SIZE_T Bytes = 0;
+	int32 NumTextures = 0;
+
+	auto AddTexture = [&](const FTextureEntry& Entry)
+	{
+		if (UTexture2D* Texture = Entry.GetOwnedTexture())
+		{
+			Bytes += Texture->CalcTextureMemorySizeEnum(TMC_AllMips);
+			NumTextures++;
+		}
+	};
+
+	AddTexture(ErrorTexture);
+	for (const FTextureEntry& Entry : TextureResources)
+	{
+		AddTexture(Entry);
+	}
+
+	for (const auto& Pair : DynamicTextures)
+	{
+		Bytes += Pair.Value->GetAllocatedSize();
+	}
+
+	if (OutNumTextures)
+	{
+		*OutNumTextures = NumTextures;
+	}
+
+	return Bytes;
 }
 
 TextureIndex FTextureManager::CreateTextureInternal(const FName& Name, int32 Width, int32 Height, uint32 SrcBpp, uint8* SrcData, TFunction<void(uint8*)> SrcDataCleanup)
 {
+	IMGUI_LLM_SCOPE(Textures);
+
 	// Create a texture.
 	UTexture2D* Texture = UTexture2D::CreateTransient(Width, Height);
 
@@ -89,25 +265,230 @@ TextureIndex FTextureManager::CreatePlainTextureInternal(const FName& Name, int3
 
 TextureIndex FTextureManager::AddTextureEntry(const FName& Name, UTexture2D* Texture, bool bAddToRoot)
 {
-	// Try to find an entry with that name.
-	TextureIndex Index = FindTextureIndex(Name);
+	IMGUI_LLM_SCOPE(Textures);
 
-	// If this is a new name, try to find an entry to reuse.
+	// Update an entry with that name or, if this is a new name, reuse or add an entry.
+	TextureIndex Index = FindTextureIndex(Name);
 	if (Index == INDEX_NONE)
 	{
-		Index = FindTextureIndex(NAME_None);
+		const int32 EntryIndex = AllocateTextureEntry();
+		Index = MakeTextureIndex(EntryIndex, TextureResources[EntryIndex].Generation);
+		NameToIndex.Add(Name, Index);
+	}
+	else
+	{
+		// Updated texture can have a different size, so it needs to be packed again.
+		RemoveFromAtlas(GetEntryIndex(Index));
+
+		// Updated texture is not dynamic, unless it is recreated as such.
+		DynamicTextures.Remove(Index);
 	}
 
-	// Either update/reuse an entry or add a new one.
-	if (Index != INDEX_NONE)
+	TextureResources[GetEntryIndex(Index)] = { Name, Texture, bAddToRoot };
+	return Index;
+}
+
+int32 FTextureManager::AllocateTextureEntry()
+{
+	if (FirstFreeIndex != INDEX_NONE)
 	{
-		TextureResources[Index] = { Name, Texture, bAddToRoot };
-		return Index;
+		const int32 EntryIndex = FirstFreeIndex;
+		FirstFreeIndex = TextureResources[EntryIndex].NextFreeIndex;
+		TextureResources[EntryIndex].NextFreeIndex = INDEX_NONE;
+
+		if (FirstFreeIndex == INDEX_NONE)
+		{
+			LastFreeIndex = INDEX_NONE;
+		}
+
+		return EntryIndex;
 	}
-	else
+
+	checkf(static_cast<uint32>(TextureResources.Num()) <= EntryIndexMask,
+		TEXT("Too many texture entries. Texture indices support up to %u entries."), EntryIndexMask + 1);
+
+	return TextureResources.AddDefaulted();
+}
+
+void FTextureManager::AddToAtlas(TextureIndex Index, UTexture2D* Texture)
+{
+#if ENGINE_COMPATIBILITY_WITH_RHI_COPY_TEXTURE
+	// Texture registered again under the same index replaces the one that was waiting to be streamed in.
+	PendingAtlasTextures.RemoveAllSwap([Index](const TPair<TextureIndex, TWeakObjectPtr<UTexture2D>>& Pending)
+	{
+		return Pending.Key == Index;
+	});
+
+	const int32 MaxSize = FMath::Min(CVars::TextureAtlasMaxSize.GetValueOnGameThread(), AtlasPageSize / 4);
+	if (MaxSize <= 0)
+	{
+		return;
+	}
+
+	// Copying only works with a resident top mip, so textures that are not yet streamed in are packed later.
+	FTextureResource* SrcResource = Texture->Resource;
+	if (!SrcResource || !Texture->IsFullyStreamedIn())
+	{
+		PendingAtlasTextures.Emplace(Index, Texture);
+		return;
+	}
+
+	// Size of the resource can be smaller than the size of the texture, if the texture has a LOD bias.
+	const int32 Width = SrcResource->GetSizeX();
+	const int32 Height = SrcResource->GetSizeY();
+	const EPixelFormat Format = Texture->GetPixelFormat();
+	if (Width <= 0 || Height <= 0 || Width > MaxSize || Height > MaxSize || Format == PF_Unknown)
 	{
-		return TextureResources.Emplace(Name, Texture, bAddToRoot);
+		return;
+	}
+
+	// Block-compressed textures can be only copied in whole blocks.
+	const int32 BlockSizeX = GPixelFormats[Format].BlockSizeX;
+	const int32 BlockSizeY = GPixelFormats[Format].BlockSizeY;
+	if (Width % BlockSizeX != 0 || Height % BlockSizeY != 0)
+	{
+		return;
+	}
+
+	// Textures are surrounded by gutters filled with their edge texels, so bilinear filtering at edges doesn't sample
+	// neighbours. Block-compressed textures can only be extruded in whole blocks, so their gutters repeat edge blocks.
+	const FIntPoint Gutter{ BlockSizeX, BlockSizeY };
+	const int32 AllocationWidth = Width + 2 * Gutter.X;
+	const int32 AllocationHeight = Height + 2 * Gutter.Y;
+
+	int32 PageNb = INDEX_NONE;
+	FIntPoint Position;
+	for (int32 Nb = 0; Nb < AtlasPages.Num() && PageNb == INDEX_NONE; Nb++)
+	{
+		FAtlasPage& Page = AtlasPages[Nb];
+		if (Page.Format == Format && Page.bSRGB == Texture->SRGB && Page.Allocate(AllocationWidth, AllocationHeight, Position))
+		{
+			PageNb = Nb;
+		}
 	}
+
+	if (PageNb == INDEX_NONE)
+	{
+		PageNb = CreateAtlasPage(Format, Texture->SRGB);
+		verify(AtlasPages[PageNb].Allocate(AllocationWidth, AllocationHeight, Position));
+	}
+
+	FAtlasPage& Page = AtlasPages[PageNb];
+	Page.NumTextures++;
+
+	FTextureEntry& Entry = TextureResources[GetEntryIndex(Index)];
+	Entry.AtlasPage = PageNb;
+	Entry.AtlasUVOffset = FVector2D(Position + Gutter) / AtlasPageSize;
+	Entry.AtlasUVScale = FVector2D(Width, Height) / AtlasPageSize;
+	AtlasVersion++;
+
+	// Copy the top mip to the page. Resources are released in render commands, so they are valid when this runs.
+	FTextureResource* DstResource = TextureResources[GetEntryIndex(Page.Index)].GetOwnedTexture()->Resource;
+	ENQUEUE_RENDER_COMMAND(ImGuiCopyTextureToAtlas)([SrcResource, DstResource, Position, Gutter, Width, Height](FRHICommandListImmediate& RHICmdList)
+	{
+		FRHITexture* Src = SrcResource->TextureRHI;
+		FRHITexture* Dst = DstResource->TextureRHI;
+		if (Src && Dst)
+		{
+#if ENGINE_COMPATIBILITY_WITH_RHI_TRANSITIONS
+			RHICmdList.Transition({ FRHITransitionInfo(Src, ERHIAccess::SRVMask, ERHIAccess::CopySrc),
+				FRHITransitionInfo(Dst, ERHIAccess::SRVMask, ERHIAccess::CopyDest) });
+#endif
+
+			// Copy the texture and extrude its edges and corners into gutters. In every dimension, source range is
+			// either the whole texture, its first or last gutter-sized strip, with the matching destination range.
+			const int32 SrcX[] = { 0, 0, Width - Gutter.X };
+			const int32 SrcY[] = { 0, 0, Height - Gutter.Y };
+			const int32 DstX[] = { Position.X + Gutter.X, Position.X, Position.X + Gutter.X + Width };
+			const int32 DstY[] = { Position.Y + Gutter.Y, Position.Y, Position.Y + Gutter.Y + Height };
+			const int32 SizeX[] = { Width, Gutter.X, Gutter.X };
+			const int32 SizeY[] = { Height, Gutter.Y, Gutter.Y };
+
+			for (int32 Y = 0; Y < 3; Y++)
+			{
+				for (int32 X = 0; X < 3; X++)
+				{
+					FRHICopyTextureInfo CopyInfo;
+					CopyInfo.Size = FIntVector(SizeX[X], SizeY[Y], 1);
+					CopyInfo.SourcePosition = FIntVector(SrcX[X], SrcY[Y], 0);
+					CopyInfo.DestPosition = FIntVector(DstX[X], DstY[Y], 0);
+					RHICmdList.CopyTexture(Src, Dst, CopyInfo);
+				}
+			}
+
+#if ENGINE_COMPATIBILITY_WITH_RHI_TRANSITIONS
+			RHICmdList.Transition({ FRHITransitionInfo(Src, ERHIAccess::CopySrc, ERHIAccess::SRVMask),
+				FRHITransitionInfo(Dst, ERHIAccess::CopyDest, ERHIAccess::SRVMask) });
+#endif
+		}
+	});
+#endif // ENGINE_COMPATIBILITY_WITH_RHI_COPY_TEXTURE
+}
+
+void FTextureManager::RemoveFromAtlas(int32 EntryIndex)
+{
+	FTextureEntry& Entry = TextureResources[EntryIndex];
+	if (Entry.AtlasPage != INDEX_NONE)
+	{
+		FAtlasPage& Page = AtlasPages[Entry.AtlasPage];
+		if (--Page.NumTextures == 0)
+		{
+			Page.Reset();
+		}
+
+		Entry.AtlasPage = INDEX_NONE;
+		AtlasVersion++;
+	}
+}
+
+int32 FTextureManager::CreateAtlasPage(EPixelFormat Format, bool bSRGB)
+{
+	IMGUI_LLM_SCOPE(Textures);
+
+	UTexture2D* Texture = UTexture2D::CreateTransient(AtlasPageSize, AtlasPageSize, Format);
+	Texture->SRGB = bSRGB;
+
+	// Clear the page, so unused areas are transparent.
+	FTexture2DMipMap& Mip = Texture->PlatformData->Mips[0];
+	FMemory::Memzero(Mip.BulkData.Lock(LOCK_READ_WRITE), Mip.BulkData.GetBulkDataSize());
+	Mip.BulkData.Unlock();
+
+	Texture->UpdateResource();
+
+	const int32 PageNb = AtlasPages.AddDefaulted();
+	FAtlasPage& Page = AtlasPages[PageNb];
+	Page.Format = Format;
+	Page.bSRGB = bSRGB;
+	Page.Index = AddTextureEntry(FName(TEXT("ImGuiModule_AtlasPage"), PageNb + 1), Texture, true);
+	return PageNb;
+}
+
+bool FTextureManager::FAtlasPage::Allocate(int32 Width, int32 Height, FIntPoint& OutPosition)
+{
+	// Start a new shelf, if this one is full.
+	if (CursorX + Width > AtlasPageSize)
+	{
+		ShelfY += ShelfHeight;
+		ShelfHeight = 0;
+		CursorX = 0;
+	}
+
+	if (ShelfY + Height > AtlasPageSize)
+	{
+		return false;
+	}
+
+	OutPosition = { CursorX, ShelfY };
+	CursorX += Width;
+	ShelfHeight = FMath::Max(ShelfHeight, Height);
+	return true;
+}
+
+void FTextureManager::FAtlasPage::Reset()
+{
+	ShelfY = 0;
+	ShelfHeight = 0;
+	CursorX = 0;
 }
 
 FTextureManager::FTextureEntry::FTextureEntry(const FName& InName, UTexture2D* InTexture, bool bAddToRoot)
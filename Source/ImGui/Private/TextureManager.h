@@ -2,18 +2,26 @@
 
 #pragma once
 
+#include "DynamicTexture.h"
+
+#include <Containers/Map.h>
+#include <PixelFormat.h>
 #include <Styling/SlateBrush.h>
+#include <Templates/UniquePtr.h>
 #include <Textures/SlateShaderResource.h>
 #include <UObject/WeakObjectPtr.h>
 
 
 class UTexture2D;
 
-// Index type to be used as a texture handle.
+// Index type to be used as a texture handle. It combines the index of a texture entry with the generation of that entry,
+// so indices of released textures don't match textures that reuse their entries.
 using TextureIndex = int32;
 
 // Manager for textures resources which can be referenced by a unique name or index.
-// Name is primarily for lookup and index provides a direct access to resources.
+// Name is primarily for lookup and index provides a direct access to resources. Indices are not reused after releasing
+// resources until their entry wraps around all generations (see TextureIndex), so they can be validated without
+// comparing names.
 class FTextureManager
 {
 public:
@@ -41,15 +49,27 @@ public:
 	// @returns The index of a texture with given name or INDEX_NONE if there is no such texture
 	TextureIndex FindTextureIndex(const FName& Name) const
 	{
-		return TextureResources.IndexOfByPredicate([&](const auto& Entry) { return Entry.GetName() == Name; });
+		const TextureIndex* Index = NameToIndex.Find(Name);
+		return Index ? *Index : INDEX_NONE;
 	}
 
-	// Get the name of a texture at given index. Returns NAME_None, if index is out of range.
+	// Get the name of a texture at given index. Returns NAME_None, if index is not valid.
 	// @param Index - Index of a texture
-	// @returns The name of a texture at given index or NAME_None if index is out of range.
+	// @returns The name of a texture at given index or NAME_None if index is not valid.
 	FName GetTextureName(TextureIndex Index) const
 	{
-		return IsInRange(Index) ? TextureResources[Index].GetName() : NAME_None;
+		return IsValidTexture(Index) ? TextureResources[GetEntryIndex(Index)].GetName() : NAME_None;
+	}
+
+	// Check whether index points to valid texture resources. Indices of released textures are not valid, even if their
+	// entries are reused.
+	// @param Index - Index of a texture
+	// @returns True, if index points to valid texture resources
+	FORCEINLINE bool IsValidTexture(TextureIndex Index) const
+	{
+		const int32 EntryIndex = GetEntryIndex(Index);
+		return Index >= 0 && IsInRange(EntryIndex) && TextureResources[EntryIndex].Generation == GetGeneration(Index)
+			&& TextureResources[EntryIndex].GetName() != NAME_None;
 	}
 
 	// Get the Slate Resource Handle to a texture at given index. If index is out of range or resources are not valid
@@ -59,7 +79,7 @@ public:
 	// found at given index
 	const FSlateResourceHandle& GetTextureHandle(TextureIndex Index) const
 	{
-		return IsValidTexture(Index) ? TextureResources[Index].GetResourceHandle() : ErrorTexture.GetResourceHandle();
+		return IsValidTexture(Index) ? TextureResources[GetEntryIndex(Index)].GetResourceHandle() : ErrorTexture.GetResourceHandle();
 	}
 
 	// Create a texture from raw data.
@@ -72,6 +92,15 @@ public:
 	// @returns The index of a texture that was created
 	TextureIndex CreateTexture(const FName& Name, int32 Width, int32 Height, uint32 SrcBpp, uint8* SrcData, TFunction<void(uint8*)> SrcDataCleanup = [](uint8*) {});
 
+	// Update a rectangle of a texture created from raw data. Unlike dynamic textures, it doesn't keep staging buffers:
+	// source data are passed to the render thread and released after the upload. Ignores indices of released textures.
+	// @param Index - The index of a texture created with CreateTexture
+	// @param Rect - Rectangle to update (it should be inside of the texture)
+	// @param SrcBpp - The size in bytes of one pixel
+	// @param SrcData - The source data, starting from the first texel of the rectangle, with rows of the rectangle width
+	// @param SrcDataCleanup - Optional function called to release source data after texture is updated
+	void UpdateTexture(TextureIndex Index, const FIntRect& Rect, uint32 SrcBpp, uint8* SrcData, TFunction<void(uint8*)> SrcDataCleanup = [](uint8*) {});
+
 	// Create a plain texture.
 	// @param Name - The texture name
 	// @param Width - The texture width
@@ -86,10 +115,67 @@ public:
 	// @returns The index to created/updated texture resources
 	TextureIndex CreateTextureResources(const FName& Name, UTexture2D* Texture);
 
-	// Release resources for given texture. Ignores invalid indices.
+	// Create a dynamic texture, which content can be updated from CPU buffers.
+	// @param Name - The texture name
+	// @param Width - The texture width
+	// @param Height - The texture height
+	// @param Format - Uncompressed pixel format
+	// @returns The index of a texture that was created
+	TextureIndex CreateDynamicTexture(const FName& Name, int32 Width, int32 Height, EPixelFormat Format);
+
+	// Update a rectangle of a dynamic texture. Updates are staged and uploaded with FlushDynamicTextures. Ignores indices
+	// of released textures.
+	// @param Index - The index of a dynamic texture
+	// @param Rect - Rectangle to update (clamped to the texture size)
+	// @param Data - Source data, starting from the first texel of the rectangle
+	// @param SrcPitch - Number of bytes between rows of source data
+	void UpdateDynamicTexture(TextureIndex Index, const FIntRect& Rect, const uint8* Data, int32 SrcPitch);
+
+	// Upload all updates of dynamic textures made since the last flush. Should be called once per frame.
+	void FlushDynamicTextures();
+
+	// Pack textures into atlas pages, if they were not fully streamed in when registered. Should be called once per
+	// frame.
+	void UpdateAtlas();
+
+	// Get the atlas page into which a texture was packed. Textures registered with CreateTextureResources can be packed
+	// into shared atlas pages (see ImGui.TextureAtlas.MaxSize), so they can be drawn together with other textures.
+	// It doesn't modify the manager, so it can be called from worker threads, as long as no textures are created or
+	// released at the same time.
+	// @param Index - Index of a texture
+	// @param OutPageIndex - Receives the texture index of the atlas page
+	// @param OutUVOffset - Receives the offset of the texture in the page UV space
+	// @param OutUVScale - Receives the size of the texture in the page UV space
+	// @returns True, if texture was packed into an atlas page
+	bool GetAtlasPlacement(TextureIndex Index, TextureIndex& OutPageIndex, FVector2D& OutUVOffset, FVector2D& OutUVScale) const
+	{
+		if (IsValidTexture(Index))
+		{
+			const FTextureEntry& Entry = TextureResources[GetEntryIndex(Index)];
+			if (Entry.AtlasPage != INDEX_NONE)
+			{
+				OutPageIndex = AtlasPages[Entry.AtlasPage].Index;
+				OutUVOffset = Entry.AtlasUVOffset;
+				OutUVScale = Entry.AtlasUVScale;
+				return true;
+			}
+		}
+		return false;
+	}
+
+	// Get the version of atlas placements, which changes whenever an existing texture index is packed into or removed
+	// from an atlas page. It can be used to detect when data prepared with GetAtlasPlacement are outdated.
+	uint32 GetAtlasVersion() const { return AtlasVersion; }
+
+	// Release resources for given texture. Ignores indices of already released textures.
 	// @param Index - The index of a texture resources
 	void ReleaseTextureResources(TextureIndex Index);
 
+	// Get the number of bytes used by textures created by this manager. Textures managed externally are not included.
+	// @param OutNumTextures - If not null, it receives the number of textures included in the result
+	// @returns The number of bytes used by textures created by this manager
+	SIZE_T GetTextureMemory(int32* OutNumTextures = nullptr) const;
+
 private:
 
 	// See CreateTexture for general description.
@@ -109,16 +195,45 @@ private:
 	// @returns The index of the entry that we created or reused
 	TextureIndex AddTextureEntry(const FName& Name, UTexture2D* Texture, bool bAddToRoot);
 
-	// Check whether index is in range allocated for TextureResources (it doesn't mean that resources are valid).
-	FORCEINLINE bool IsInRange(TextureIndex Index) const
+	// Try to pack a texture into an atlas page. Only small textures with resident top mip are packed. Textures that are
+	// not fully streamed in are queued and packed in UpdateAtlas, once they are.
+	// @param Index - Index of the texture entry
+	// @param Texture - The texture
+	void AddToAtlas(TextureIndex Index, UTexture2D* Texture);
+
+	// Remove an entry from its atlas page, if it was packed.
+	void RemoveFromAtlas(int32 EntryIndex);
+
+	// Create an empty atlas page.
+	// @returns The index of the page in AtlasPages
+	int32 CreateAtlasPage(EPixelFormat Format, bool bSRGB);
+
+	// Get an unused entry from the free list or add a new one.
+	// @returns The index of an unused entry in TextureResources
+	int32 AllocateTextureEntry();
+
+	// Number of bits of texture index used to store the entry index. Remaining bits, except for the sign bit, store
+	// the generation, which wraps around after MaxGeneration.
+	static constexpr int32 EntryIndexBits = 20;
+	static constexpr uint32 EntryIndexMask = (1u << EntryIndexBits) - 1;
+	static constexpr uint32 MaxGeneration = (1u << (31 - EntryIndexBits)) - 1;
+
+	// Get the index of an entry in TextureResources from a texture index.
+	static FORCEINLINE int32 GetEntryIndex(TextureIndex Index) { return static_cast<int32>(Index & EntryIndexMask); }
+
+	// Get the generation of an entry from a texture index.
+	static FORCEINLINE uint32 GetGeneration(TextureIndex Index) { return static_cast<uint32>(Index) >> EntryIndexBits; }
+
+	// Make a texture index from an entry index and generation.
+	static FORCEINLINE TextureIndex MakeTextureIndex(int32 EntryIndex, uint32 Generation)
 	{
-		return static_cast<uint32>(Index) < static_cast<uint32>(TextureResources.Num());
+		return static_cast<TextureIndex>((Generation << EntryIndexBits) | static_cast<uint32>(EntryIndex));
 	}
 
-	// Check whether index is in range and whether texture resources are valid (using NAME_None sentinel).
-	FORCEINLINE bool IsValidTexture(TextureIndex Index) const
+	// Check whether entry index is in range allocated for TextureResources (it doesn't mean that resources are valid).
+	FORCEINLINE bool IsInRange(int32 EntryIndex) const
 	{
-		return IsInRange(Index) && TextureResources[Index].GetName() != NAME_None;
+		return static_cast<uint32>(EntryIndex) < static_cast<uint32>(TextureResources.Num());
 	}
 
 	// Entry for texture resources. Only supports explicit construction.
@@ -140,6 +255,20 @@ private:
 		const FName& GetName() const { return Name; }
 		const FSlateResourceHandle& GetResourceHandle() const;
 
+		// Get the texture, if it is owned by this entry.
+		UTexture2D* GetOwnedTexture() const { return Texture.Get(); }
+
+		// Index of the next entry in the free list (only used by unused entries).
+		int32 NextFreeIndex = INDEX_NONE;
+
+		// Generation of this entry, incremented whenever resources are released (wraps around after MaxGeneration).
+		uint32 Generation = 0;
+
+		// Atlas page into which the texture was packed (INDEX_NONE if not packed) and the texture UV sub-rectangle.
+		int32 AtlasPage = INDEX_NONE;
+		FVector2D AtlasUVOffset = FVector2D::ZeroVector;
+		FVector2D AtlasUVScale = FVector2D::UnitVector;
+
 	private:
 
 		void Reset(bool bReleaseResources);
@@ -153,6 +282,47 @@ private:
 	TArray<FTextureEntry> TextureResources;
 	FTextureEntry ErrorTexture;
 
+	// Texture indices by names (only entries in use).
+	TMap<FName, TextureIndex> NameToIndex;
+
+	// Head and tail of the list of released entries, linked through entries themselves. Entries are reused from
+	// the head, except for entries with wrapped generations, which are added to the tail.
+	int32 FirstFreeIndex = INDEX_NONE;
+	int32 LastFreeIndex = INDEX_NONE;
+
+	// Page of the texture atlas. Pages are registered as own textures, so they can be drawn like any other texture.
+	// Textures are packed in shelves (rows), from left to right. Space is only reclaimed after all textures in a page
+	// are released.
+	struct FAtlasPage
+	{
+		// Try to allocate a rectangle in this page.
+		bool Allocate(int32 Width, int32 Height, FIntPoint& OutPosition);
+
+		// Reset packing, so the whole page can be reused.
+		void Reset();
+
+		TextureIndex Index = INDEX_NONE;
+		EPixelFormat Format = PF_Unknown;
+		bool bSRGB = true;
+
+		int32 ShelfY = 0;
+		int32 ShelfHeight = 0;
+		int32 CursorX = 0;
+
+		int32 NumTextures = 0;
+	};
+
+	static constexpr int32 AtlasPageSize = 1024;
+
+	TArray<FAtlasPage> AtlasPages;
+	uint32 AtlasVersion = 0;
+
+	// Textures waiting to be fully streamed in, before they can be packed into atlas pages.
+	TArray<TPair<TextureIndex, TWeakObjectPtr<UTexture2D>>> PendingAtlasTextures;
+
+	// Staging of dynamic textures by texture indices.
+	TMap<TextureIndex, TUniquePtr<FDynamicTexture>> DynamicTextures;
+
 	static constexpr EName NAME_ErrorTexture = NAME_None;
 	static constexpr TextureIndex INDEX_ErrorTexture = INDEX_NONE;
 };
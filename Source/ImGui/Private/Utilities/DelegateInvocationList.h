@@ -0,0 +1,86 @@
+// Distributed under the MIT License (MIT) (see accompanying LICENSE file)
+
+#pragma once
+
+#include "VersionCompatibility.h"
+
+#include <Delegates/Delegate.h>
+
+
+#if ENGINE_COMPATIBILITY_WITH_DELEGATE_INSTANCE_API
+
+namespace Utilities
+{
+	// Gives access to functions bound to a simple multicast delegate, so they can be called one by one. For as long as
+	// this object exists, the invocation list is locked in the same way as during broadcast: functions removed by
+	// callees are only unbound and functions added by callees are ignored.
+	class FDelegateInvocationList
+	{
+	public:
+
+		FDelegateInvocationList(const FSimpleMulticastDelegate& InDelegate)
+			: Delegate(static_cast<const FAccess&>(InDelegate))
+		{
+			Delegate.LockInvocationList();
+			Num = Delegate.GetInvocationList().Num();
+		}
+
+		~FDelegateInvocationList()
+		{
+			Delegate.UnlockInvocationList();
+
+			if (bNeedsCompaction)
+			{
+				const_cast<FAccess&>(Delegate).CompactInvocationList();
+			}
+		}
+
+		FDelegateInvocationList(const FDelegateInvocationList&) = delete;
+		FDelegateInvocationList& operator=(const FDelegateInvocationList&) = delete;
+
+		// Get the number of functions bound when this object was created.
+		int32 NumFunctions() const { return Num; }
+
+		// Get a function in the broadcast order (which is the reverse of the binding order).
+		// @param Index - Index of the function in the broadcast order
+		// @returns Delegate instance of the function or null, if it was unbound
+		const IBaseDelegateInstance<void()>* GetFunction(int32 Index) const
+		{
+			check(Index >= 0 && Index < Num);
+			return static_cast<const IBaseDelegateInstance<void()>*>(
+				FAccess::GetDelegateInstanceProtectedHelper(Delegate.GetInvocationList()[Num - 1 - Index]));
+		}
+
+		// Call a function, if it is still bound.
+		// @param Index - Index of the function in the broadcast order
+		// @returns True, if function was called
+		bool CallFunction(int32 Index)
+		{
+			const IBaseDelegateInstance<void()>* Function = GetFunction(Index);
+			if (!Function || !Function->ExecuteIfSafe())
+			{
+				bNeedsCompaction = true;
+				return false;
+			}
+			return true;
+		}
+
+	private:
+
+		// Derived type which can access the protected invocation list API.
+		struct FAccess : public FSimpleMulticastDelegate
+		{
+			using FSimpleMulticastDelegate::LockInvocationList;
+			using FSimpleMulticastDelegate::UnlockInvocationList;
+			using FSimpleMulticastDelegate::GetInvocationList;
+			using FSimpleMulticastDelegate::CompactInvocationList;
+			using FSimpleMulticastDelegate::GetDelegateInstanceProtectedHelper;
+		};
+
+		const FAccess& Delegate;
+		int32 Num = 0;
+		bool bNeedsCompaction = false;
+	};
+}
+
+#endif // ENGINE_COMPATIBILITY_WITH_DELEGATE_INSTANCE_API
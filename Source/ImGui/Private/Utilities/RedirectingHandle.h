@@ -19,7 +19,7 @@ namespace Utilities
 		{
 		}
 
-		~TRedirectingHandle()
+		virtual ~TRedirectingHandle()
 		{
 			// Broadcast null pointer as a request to detach.
 			OnRedirectionUpdate.Broadcast(nullptr);
@@ -43,6 +43,8 @@ namespace Utilities
 		{
 			if (InParent != Parent)
 			{
+				TRedirectingHandle* OldParent = Parent;
+
 				if (Parent)
 				{
 					Parent->OnRedirectionUpdate.RemoveAll(this);
@@ -57,11 +59,20 @@ namespace Utilities
 				}
 
 				SetHandle((Parent) ? Parent->Handle : DefaultHandle);
+
+				OnParentChanged(OldParent);
 			}
 		}
 
 	protected:
 
+		// Called after this handle is attached to a different parent or detached. This is also called when a parent
+		// is destroyed, so derived handles that access their old parents should detach children in their destructors.
+		virtual void OnParentChanged(TRedirectingHandle* OldParent) {}
+
+		// Called after this handle is redirected to a different value, including redirections that come from parents.
+		virtual void OnHandleChanged() {}
+
 		void UpdateRedirection(T* InHandle)
 		{
 			if (InHandle)
@@ -80,6 +91,7 @@ namespace Utilities
 			if (InHandle != Handle)
 			{
 				Handle = InHandle;
+				OnHandleChanged();
 				OnRedirectionUpdate.Broadcast(Handle);
 			}
 		}
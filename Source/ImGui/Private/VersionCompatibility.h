@@ -13,7 +13,8 @@
 // rectangle and unofficial GSlateScissorRect to correctly clip custom vertices made with FSlateDrawElement.
 #define ENGINE_COMPATIBILITY_LEGACY_CLIPPING_API        BELOW_ENGINE_VERSION(4, 17)
 
-// Starting from version 4.18, FPaths::GameSavedDir() has been superseded by FPaths::ProjectSavedDir().
+// Starting from version 4.18, FPaths::GameSavedDir() has been superseded by FPaths::ProjectSavedDir() (and the same goes
+// for FPaths::GameDir() and FPaths::ProjectDir()).
 #define ENGINE_COMPATIBILITY_LEGACY_SAVED_DIR           BELOW_ENGINE_VERSION(4, 18)
 
 // Starting from version 4.18, we have support for dual key bindings.
@@ -33,3 +34,22 @@
 
 // Starting from version 4.26, FKey::IsFloatAxis and FKey::IsVectorAxis are deprecated and replaced with FKey::IsAxis[1|2|3]D methods.
 #define ENGINE_COMPATIBILITY_LEGACY_KEY_AXIS_API        BELOW_ENGINE_VERSION(4, 26)
+
+// Starting from version 4.18, engine has a low-level memory tracker with a predefined set of tags.
+#define ENGINE_COMPATIBILITY_WITH_LLM                   FROM_ENGINE_VERSION(4, 18)
+
+// Starting from version 4.27, low-level memory tracker supports tags defined in modules.
+#define ENGINE_COMPATIBILITY_WITH_LLM_MODULE_TAGS       FROM_ENGINE_VERSION(4, 27)
+
+// Starting from version 4.26, CPU profiler trace supports custom channels, which can be enabled independently.
+#define ENGINE_COMPATIBILITY_WITH_TRACE_CHANNELS        FROM_ENGINE_VERSION(4, 26)
+
+// Starting from version 4.26, multicast delegates are based on templated user policies, with delegate instances that
+// can be accessed by derived classes. We need that to call bound functions one by one.
+#define ENGINE_COMPATIBILITY_WITH_DELEGATE_INSTANCE_API FROM_ENGINE_VERSION(4, 26)
+
+// Starting from version 4.23, RHI can copy regions between textures, which we use to pack textures into atlas pages.
+#define ENGINE_COMPATIBILITY_WITH_RHI_COPY_TEXTURE      FROM_ENGINE_VERSION(4, 23)
+
+// Starting from version 4.26, RHI resources need explicit transitions between access states.
+#define ENGINE_COMPATIBILITY_WITH_RHI_TRANSITIONS       FROM_ENGINE_VERSION(4, 26)
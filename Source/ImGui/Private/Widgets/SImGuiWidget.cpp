@@ -61,8 +61,28 @@ namespace CVars
 }
 #endif // IMGUI_WIDGET_DEBUG
 
+DECLARE_DWORD_COUNTER_STAT(TEXT("Vertex Bytes Submitted"), STAT_ImGui_VertexBytesSubmitted, STATGROUP_ImGui);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Vertex Bytes Submitted Without Per-Command Ranges"), STAT_ImGui_VertexBytesWithoutRanges, STATGROUP_ImGui);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Draw Elements Submitted"), STAT_ImGui_DrawElementsSubmitted, STATGROUP_ImGui);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Draw Elements Saved By Merging"), STAT_ImGui_DrawElementsSaved, STATGROUP_ImGui);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Clipping Zones Saved"), STAT_ImGui_ClippingZonesSaved, STATGROUP_ImGui);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Draw Lists Culled"), STAT_ImGui_DrawListsCulled, STATGROUP_ImGui);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Draw Commands Culled"), STAT_ImGui_DrawCommandsCulled, STATGROUP_ImGui);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Distinct Textures Before Atlasing"), STAT_ImGui_DistinctSourceTextures, STATGROUP_ImGui);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Distinct Textures Painted"), STAT_ImGui_DistinctPaintedTextures, STATGROUP_ImGui);
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Paint Elements Reused"), STAT_ImGui_PaintElementsReused, STATGROUP_ImGui);
+
+DECLARE_CYCLE_STAT(TEXT("Widget Paint"), STAT_ImGui_WidgetPaint, STATGROUP_ImGui);
+DECLARE_CYCLE_STAT(TEXT("Widget Build Paint Elements"), STAT_ImGui_WidgetBuildPaintElements, STATGROUP_ImGui);
+
 namespace
 {
+#if ENGINE_COMPATIBILITY_WITH_TRACE_CHANNELS
+	// Name used in trace scopes of widgets without a context.
+	const FString NullContextName = TEXT("None");
+#endif
+
 	FORCEINLINE FVector2D MaxVector(const FVector2D& A, const FVector2D& B)
 	{
 		return FVector2D(FMath::Max(A.X, B.X), FMath::Max(A.Y, B.Y));
@@ -77,6 +97,19 @@ namespace
 	{
 		return FSlateRenderTransform(Transform.GetMatrix(), RoundVector(Transform.GetTranslation()));
 	}
+
+	// Whether rectangle doesn't cover any pixel.
+	FORCEINLINE bool IsEmptyRect(const FSlateRect& Rect)
+	{
+		return FMath::RoundToInt(Rect.Right) <= FMath::RoundToInt(Rect.Left) || FMath::RoundToInt(Rect.Bottom) <= FMath::RoundToInt(Rect.Top);
+	}
+
+	// Clipping is applied with pixel precision, so rectangles that round to the same pixels are equivalent.
+	FORCEINLINE bool IsSameClippingRect(const FSlateRect& A, const FSlateRect& B)
+	{
+		return FMath::RoundToInt(A.Left) == FMath::RoundToInt(B.Left) && FMath::RoundToInt(A.Top) == FMath::RoundToInt(B.Top)
+			&& FMath::RoundToInt(A.Right) == FMath::RoundToInt(B.Right) && FMath::RoundToInt(A.Bottom) == FMath::RoundToInt(B.Bottom);
+	}
 }
 
 BEGIN_SLATE_FUNCTION_BUILD_OPTIMIZATION
@@ -626,65 +659,211 @@ FVector2D SImGuiWidget::TransformScreenPointToImGui(const FGeometry& MyGeometry,
 int32 SImGuiWidget::OnPaint(const FPaintArgs& Args, const FGeometry& AllottedGeometry, const FSlateRect& MyClippingRect,
 	FSlateWindowElementList& OutDrawElements, int32 LayerId, const FWidgetStyle& WidgetStyle, bool bParentEnabled) const
 {
-	if (FImGuiContextProxy* ContextProxy = ModuleManager->GetContextManager().GetContextProxy(ContextIndex))
+	SCOPE_CYCLE_COUNTER(STAT_ImGui_WidgetPaint);
+
+	FImGuiContextProxy* ContextProxy = ModuleManager->GetContextManager().GetContextProxy(ContextIndex);
+	IMGUI_TRACE_CONTEXT_SCOPE("ImGui Widget Paint", ContextProxy ? ContextProxy->GetName() : NullContextName);
+
+	if (ContextProxy)
 	{
 		// Manually update ImGui context to minimise lag between creating and rendering ImGui output. This will also
 		// keep frame tearing at minimum because it is executed at the very end of the frame.
 		ContextProxy->Tick(FSlateApplication::Get().GetDeltaTime());
+	}
+
+	if (ContextProxy)
+	{
+		IMGUI_LLM_SCOPE(DrawData);
 
 		// Calculate transform from ImGui to screen space. Rounding translation is necessary to keep it pixel-perfect
 		// in older engine versions.
 		const FSlateRenderTransform& WidgetToScreen = AllottedGeometry.GetAccumulatedRenderTransform();
 		const FSlateRenderTransform ImGuiToScreen = RoundTranslation(ImGuiRenderTransform.Concatenate(WidgetToScreen));
 
+		// Elements are only rebuilt when draw data or widget geometry change. When context is idle, elements painted in
+		// the previous frame are submitted again.
+		if (!bHasPaintElements || PaintElementsContextProxy != ContextProxy
+			|| PaintElementsDrawDataVersion != ContextProxy->GetDrawDataVersion()
+			|| PaintElementsTransform != ImGuiToScreen || PaintElementsClippingRect != MyClippingRect)
+		{
+			BuildPaintElements(*ContextProxy, ImGuiToScreen, MyClippingRect);
+		}
+		else
+		{
+			INC_DWORD_STAT(STAT_ImGui_PaintElementsReused);
+		}
+
+		const FTextureManager& TextureManager = ModuleManager->GetTextureManager();
+
+#if !ENGINE_COMPATIBILITY_LEGACY_CLIPPING_API
+		// Clipping zone is kept between elements that share the same clipping rectangle.
+		TOptional<FSlateRect> PushedClippingRect;
+#endif // !ENGINE_COMPATIBILITY_LEGACY_CLIPPING_API
+
+		// Textures painted after resolving atlas pages.
+		TArray<TextureIndex, TInlineAllocator<16>> PaintedTextures;
+
+		for (int32 ElementIndex = 0; ElementIndex < NumPaintElements; ElementIndex++)
+		{
+			const FPaintElement& Element = PaintElements[ElementIndex];
+
+			// Get texture resource handle for this element (null index will be also mapped to a valid texture).
+			const FSlateResourceHandle& Handle = TextureManager.GetTextureHandle(Element.TextureId);
+
 #if ENGINE_COMPATIBILITY_LEGACY_CLIPPING_API
-		// Convert clipping rectangle to format required by Slate vertex.
-		const FSlateRotatedRect VertexClippingRect{ MyClippingRect };
+			// Get access to the Slate scissor rectangle defined in Slate Core API, so we can customize elements drawing.
+			extern SLATECORE_API TOptional<FShortRect> GSlateScissorRect;
+			TGuardValue<TOptional<FShortRect>> GSlateScissorRecGuard(GSlateScissorRect, FShortRect{ Element.ClippingRect });
+#else
+			if (!PushedClippingRect.IsSet() || !IsSameClippingRect(PushedClippingRect.GetValue(), Element.ClippingRect))
+			{
+				if (PushedClippingRect.IsSet())
+				{
+					OutDrawElements.PopClip();
+				}
+
+				OutDrawElements.PushClip(FSlateClippingZone{ Element.ClippingRect });
+				PushedClippingRect = Element.ClippingRect;
+			}
+			else
+			{
+				INC_DWORD_STAT(STAT_ImGui_ClippingZonesSaved);
+			}
 #endif // ENGINE_COMPATIBILITY_LEGACY_CLIPPING_API
 
-		for (const auto& DrawList : ContextProxy->GetDrawData())
+#if STATS
+			PaintedTextures.AddUnique(Element.TextureId);
+#endif
+
+			// Add elements to the list.
+			FSlateDrawElement::MakeCustomVerts(OutDrawElements, LayerId, Handle, Element.VertexBuffer, Element.IndexBuffer, nullptr, 0, 0);
+
+			INC_DWORD_STAT(STAT_ImGui_DrawElementsSubmitted);
+		}
+
+#if !ENGINE_COMPATIBILITY_LEGACY_CLIPPING_API
+		if (PushedClippingRect.IsSet())
 		{
+			OutDrawElements.PopClip();
+		}
+#endif // !ENGINE_COMPATIBILITY_LEGACY_CLIPPING_API
+
+		INC_DWORD_STAT_BY(STAT_ImGui_DistinctPaintedTextures, PaintedTextures.Num());
+	}
+
+	return Super::OnPaint(Args, AllottedGeometry, MyClippingRect, OutDrawElements, LayerId, WidgetStyle, bParentEnabled);
+}
+
+void SImGuiWidget::BuildPaintElements(FImGuiContextProxy& ContextProxy, const FSlateRenderTransform& ImGuiToScreen,
+	const FSlateRect& MyClippingRect) const
+{
+	SCOPE_CYCLE_COUNTER(STAT_ImGui_WidgetBuildPaintElements);
+
+	bHasPaintElements = true;
+	PaintElementsContextProxy = &ContextProxy;
+	PaintElementsDrawDataVersion = ContextProxy.GetDrawDataVersion();
+	PaintElementsTransform = ImGuiToScreen;
+	PaintElementsClippingRect = MyClippingRect;
+
+	// Elements are reused between builds, so their buffers don't need to be allocated again.
+	NumPaintElements = 0;
+
 #if ENGINE_COMPATIBILITY_LEGACY_CLIPPING_API
-			DrawList.CopyVertexData(VertexBuffer, ImGuiToScreen, VertexClippingRect);
-#else
-			DrawList.CopyVertexData(VertexBuffer, ImGuiToScreen);
+	// Convert clipping rectangle to format required by Slate vertex.
+	const FSlateRotatedRect VertexClippingRect{ MyClippingRect };
 #endif // ENGINE_COMPATIBILITY_LEGACY_CLIPPING_API
 
-			int IndexBufferOffset = 0;
-			for (int CommandNb = 0; CommandNb < DrawList.NumCommands(); CommandNb++)
+	// Textures set in ImGui before resolving atlas pages.
+	TArray<TextureIndex, TInlineAllocator<16>> SourceTextures;
+
+	for (const auto& DrawList : ContextProxy.GetDrawData())
+	{
+		// Skip lists with all vertices outside of the widget clipping rectangle (e.g. windows dragged outside of
+		// the visible area or canvas zoomed in on a different part).
+		if (!FSlateRect::DoRectanglesIntersect(DrawList.GetVertexBounds(ImGuiToScreen), MyClippingRect))
+		{
+			INC_DWORD_STAT(STAT_ImGui_DrawListsCulled);
+			continue;
+		}
+
+		int CommandNb = 0;
+		while (CommandNb < DrawList.NumCommands())
+		{
+			auto DrawCommand = DrawList.GetCommand(CommandNb++, ImGuiToScreen);
+
+			// Transform clipping rectangle to screen space and apply to elements that we draw.
+			const FSlateRect ClippingRect = DrawCommand.ClippingRect.IntersectionWith(MyClippingRect);
+
+			// Skip commands that would be completely clipped.
+			if (IsEmptyRect(ClippingRect))
+			{
+				INC_DWORD_STAT(STAT_ImGui_DrawCommandsCulled);
+				continue;
+			}
+
+			// Merge following commands that after clipping would be drawn in the same way, to reduce the number
+			// of Slate elements. Commands are not merged, if their vertices together can't be addressed with Slate
+			// indices.
+			while (CommandNb < DrawList.NumCommands())
 			{
-				const auto& DrawCommand = DrawList.GetCommand(CommandNb, ImGuiToScreen);
+				const auto& NextCommand = DrawList.GetCommand(CommandNb, ImGuiToScreen);
+				if (NextCommand.TextureId != DrawCommand.TextureId
+					|| !IsSameClippingRect(ClippingRect, NextCommand.ClippingRect.IntersectionWith(MyClippingRect))
+					|| !FImGuiDrawList::CanMergeCommands(DrawCommand, NextCommand))
+				{
+					break;
+				}
 
-				DrawList.CopyIndexData(IndexBuffer, IndexBufferOffset, DrawCommand.NumElements);
+				FImGuiDrawList::MergeCommands(DrawCommand, NextCommand);
+				CommandNb++;
 
-				// Advance offset by number of copied elements to position it for the next command.
-				IndexBufferOffset += DrawCommand.NumElements;
+				INC_DWORD_STAT(STAT_ImGui_DrawElementsSaved);
+			}
 
-				// Get texture resource handle for this draw command (null index will be also mapped to a valid texture).
-				const FSlateResourceHandle& Handle = ModuleManager->GetTextureManager().GetTextureHandle(DrawCommand.TextureId);
+			if (DrawCommand.NumElements == 0)
+			{
+				continue;
+			}
 
-				// Transform clipping rectangle to screen space and apply to elements that we draw.
-				const FSlateRect ClippingRect = DrawCommand.ClippingRect.IntersectionWith(MyClippingRect);
+			if (NumPaintElements == PaintElements.Num())
+			{
+				PaintElements.AddDefaulted();
+			}
 
+			FPaintElement& Element = PaintElements[NumPaintElements++];
+			Element.ClippingRect = ClippingRect;
+			Element.TextureId = DrawCommand.TextureId;
+
+			// Copy only vertices referenced by this command, so the total amount of copied vertices is close to
+			// the size of the vertex buffer, rather than the size multiplied by the number of commands.
 #if ENGINE_COMPATIBILITY_LEGACY_CLIPPING_API
-				// Get access to the Slate scissor rectangle defined in Slate Core API, so we can customize elements drawing.
-				extern SLATECORE_API TOptional<FShortRect> GSlateScissorRect;
-				TGuardValue<TOptional<FShortRect>> GSlateScissorRecGuard(GSlateScissorRect, FShortRect{ ClippingRect });
+			DrawList.CopyVertexData(Element.VertexBuffer, ImGuiToScreen, VertexClippingRect, DrawCommand);
 #else
-				OutDrawElements.PushClip(FSlateClippingZone{ ClippingRect });
+			DrawList.CopyVertexData(Element.VertexBuffer, ImGuiToScreen, DrawCommand);
 #endif // ENGINE_COMPATIBILITY_LEGACY_CLIPPING_API
 
-				// Add elements to the list.
-				FSlateDrawElement::MakeCustomVerts(OutDrawElements, LayerId, Handle, VertexBuffer, IndexBuffer, nullptr, 0, 0);
+			DrawList.CopyIndexData(Element.IndexBuffer, DrawCommand);
 
-#if !ENGINE_COMPATIBILITY_LEGACY_CLIPPING_API
-				OutDrawElements.PopClip();
-#endif // ENGINE_COMPATIBILITY_LEGACY_CLIPPING_API
+			INC_DWORD_STAT_BY(STAT_ImGui_VertexBytesSubmitted, DrawCommand.NumVertices * sizeof(FSlateVertex));
+			INC_DWORD_STAT_BY(STAT_ImGui_VertexBytesWithoutRanges, DrawList.NumVertices() * sizeof(FSlateVertex));
+
+#if STATS
+			for (int Nb = DrawCommand.FirstCommandNb; Nb < DrawCommand.FirstCommandNb + DrawCommand.NumCommands; Nb++)
+			{
+				SourceTextures.AddUnique(DrawList.GetSourceTexture(Nb));
 			}
+#endif
 		}
 	}
 
-	return Super::OnPaint(Args, AllottedGeometry, MyClippingRect, OutDrawElements, LayerId, WidgetStyle, bParentEnabled);
+	INC_DWORD_STAT_BY(STAT_ImGui_DistinctSourceTextures, SourceTextures.Num());
+
+	SIZE_T PaintBufferBytes = PaintElements.GetAllocatedSize();
+	for (const FPaintElement& Element : PaintElements)
+	{
+		PaintBufferBytes += Element.VertexBuffer.GetAllocatedSize() + Element.IndexBuffer.GetAllocatedSize();
+	}
+	ContextProxy.SetPaintBufferMemory(PaintBufferBytes);
 }
 
 FVector2D SImGuiWidget::ComputeDesiredSize(float Scale) const
@@ -853,9 +1032,28 @@ void SImGuiWidget::OnDebugDraw()
 			{
 				TwoColumns::Value("Context Index", ContextIndex);
 				TwoColumns::Value("Context Name", ContextProxy ? *ContextProxy->GetName() : TEXT("< Null >"));
+				TwoColumns::Value("Is Idle", ContextProxy ? ContextProxy->IsIdle() : false);
+				TwoColumns::Value("Skipped Idle Frames", ContextProxy ? ContextProxy->GetNumSkippedIdleFrames() : 0u);
+				TwoColumns::Value("Update Frequency", ContextProxy ? ContextProxy->GetUpdateFrequency() : 0.f);
+				TwoColumns::Value("Throttled Frames", ContextProxy ? ContextProxy->GetNumThrottledFrames() : 0u);
+				TwoColumns::Value("Deferred Delegates", ContextProxy ? ContextProxy->GetNumDeferredDelegates() : 0u);
 				TwoColumns::Value("Game Viewport", *GameViewport->GetName());
 			});
 
+			TwoColumns::CollapsingGroup("Memory", [&]()
+			{
+				const FImGuiContextArena::FStats Stats = ContextProxy ? ContextProxy->GetArena().GetStats() : FImGuiContextArena::FStats{};
+				const FImGuiContextProxy::FMemoryStats MemoryStats = ContextProxy ? ContextProxy->GetMemoryStats() : FImGuiContextProxy::FMemoryStats{};
+				TwoColumns::Value("Allocated Bytes", static_cast<uint32>(Stats.AllocatedBytes));
+				TwoColumns::Value("Peak Allocated Bytes", static_cast<uint32>(Stats.PeakAllocatedBytes));
+				TwoColumns::Value("Reserved Bytes", static_cast<uint32>(Stats.ReservedBytes));
+				TwoColumns::Value("Allocations", Stats.NumAllocations);
+				TwoColumns::Value("Frame Allocations", Stats.NumFrameAllocations);
+				TwoColumns::Value("Frame System Allocations", Stats.NumFrameSystemAllocations);
+				TwoColumns::Value("Draw Data Bytes", static_cast<uint32>(MemoryStats.DrawDataBytes));
+				TwoColumns::Value("Paint Buffer Bytes", static_cast<uint32>(MemoryStats.PaintBufferBytes));
+			});
+
 			TwoColumns::CollapsingGroup("Canvas Size", [&]()
 			{
 				TwoColumns::Value("Is Adaptive", bAdaptiveCanvasSize);
@@ -4,6 +4,7 @@
 
 #include "ImGuiModuleDebug.h"
 #include "ImGuiModuleSettings.h"
+#include "TextureManager.h"
 
 #include <Rendering/RenderingCommon.h>
 #include <UObject/WeakObjectPtr.h>
@@ -14,6 +15,7 @@
 // Hide ImGui Widget debug in non-developer mode.
 #define IMGUI_WIDGET_DEBUG IMGUI_MODULE_DEVELOPER
 
+class FImGuiContextProxy;
 class FImGuiModuleManager;
 class SImGuiCanvasControl;
 class UImGuiInputHandler;
@@ -120,6 +122,10 @@ private:
 
 	FVector2D TransformScreenPointToImGui(const FGeometry& MyGeometry, const FVector2D& Point) const;
 
+	// Convert draw data to Slate elements, which are kept until draw data or widget geometry change.
+	void BuildPaintElements(FImGuiContextProxy& ContextProxy, const FSlateRenderTransform& ImGuiToScreen,
+		const FSlateRect& MyClippingRect) const;
+
 	virtual int32 OnPaint(const FPaintArgs& Args, const FGeometry& AllottedGeometry, const FSlateRect& MyClippingRect, FSlateWindowElementList& OutDrawElements, int32 LayerId, const FWidgetStyle& WidgetStyle, bool bParentEnabled) const override;
 
 	virtual FVector2D ComputeDesiredSize(float) const override;
@@ -137,8 +143,25 @@ private:
 	FSlateRenderTransform ImGuiTransform;
 	FSlateRenderTransform ImGuiRenderTransform;
 
-	mutable TArray<FSlateVertex> VertexBuffer;
-	mutable TArray<SlateIndex> IndexBuffer;
+	// Slate element built from one or more ImGui draw commands.
+	struct FPaintElement
+	{
+		TArray<FSlateVertex> VertexBuffer;
+		TArray<SlateIndex> IndexBuffer;
+		FSlateRect ClippingRect;
+		TextureIndex TextureId = INDEX_NONE;
+	};
+
+	// Elements are reused between builds and only the first NumPaintElements are valid.
+	mutable TArray<FPaintElement> PaintElements;
+	mutable int32 NumPaintElements = 0;
+
+	// State for which paint elements were built.
+	mutable const FImGuiContextProxy* PaintElementsContextProxy = nullptr;
+	mutable uint32 PaintElementsDrawDataVersion = 0;
+	mutable FSlateRenderTransform PaintElementsTransform;
+	mutable FSlateRect PaintElementsClippingRect;
+	mutable bool bHasPaintElements = false;
 
 	int32 ContextIndex = 0;
 
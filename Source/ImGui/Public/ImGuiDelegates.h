@@ -7,6 +7,25 @@
 
 class UWorld;
 
+/**
+ * Priority of functions bound to ImGui world and multi-context debug delegates. It is used when the time of debug
+ * updates is limited by a frame budget (see ImGui.DebugFrameBudget), to decide which functions should be deferred.
+ */
+enum class EImGuiDelegatePriority : uint8
+{
+	/** Called after functions with higher priorities, so it is deferred first. */
+	Low,
+
+	/** Default priority. */
+	Normal,
+
+	/** Called before functions with lower priorities. */
+	High,
+
+	/** Never deferred. */
+	Critical
+};
+
 /**
  * Delegates to ImGui debug events. World delegates are called once per frame during world updates and have invocation
  * lists cleared after their worlds become invalid. Multi-context delegates are called once for every updated world.
@@ -57,6 +76,14 @@ public:
 	 * @returns Simple multicast delegate to debug events called once per frame for every world to debug
 	 */
 	static FSimpleMulticastDelegate& OnMultiContextDebug();
+
+	/**
+	 * Set the priority of a function bound to ImGui world or multi-context debug delegates. Should be called right after
+	 * binding the function. Priority is only used when debug updates are limited by a frame budget.
+	 * @param Handle - Handle to the bound function
+	 * @param Priority - Priority of the function
+	 */
+	static void SetDebugPriority(const FDelegateHandle& Handle, EImGuiDelegatePriority Priority);
 };
 
 
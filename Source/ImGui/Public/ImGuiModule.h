@@ -6,7 +6,9 @@
 #include "ImGuiModuleProperties.h"
 #include "ImGuiTextureHandle.h"
 
+#include <Math/IntRect.h>
 #include <Modules/ModuleManager.h>
+#include <PixelFormat.h>
 
 
 class FImGuiModule : public IModuleInterface
@@ -108,6 +110,42 @@ public:
 	 */
 	virtual void ReleaseTexture(const FImGuiTextureHandle& Handle);
 
+	/**
+	 * Create a dynamic texture, which content can be updated from CPU buffers (@see UpdateDynamicTexture). Texture is
+	 * registered like with RegisterTexture and it should be released with ReleaseTexture. Throws exception, if name
+	 * argument is NAME_None or format is compressed.
+	 *
+	 * @param Name - Resource name for the texture
+	 * @param Width - Texture width
+	 * @param Height - Texture height
+	 * @param Format - Uncompressed pixel format of the texture and of the data passed to updates
+	 * @returns Handle to the texture resources
+	 */
+	virtual FImGuiTextureHandle CreateDynamicTexture(const FName& Name, int32 Width, int32 Height, EPixelFormat Format = PF_B8G8R8A8);
+
+	/**
+	 * Update a rectangle of a dynamic texture. Data are copied to a staging buffer, so they don't need to outlive
+	 * this call. All updates made in a frame are merged and uploaded together, at most once per frame. If handle is
+	 * not valid or it doesn't point to a dynamic texture, this function fails silently.
+	 *
+	 * @param Handle - Handle to a dynamic texture
+	 * @param Rect - Rectangle to update (clamped to the texture size)
+	 * @param Data - Source data in the texture format, starting from the first texel of the rectangle
+	 * @param SrcPitch - Number of bytes between rows of source data
+	 */
+	virtual void UpdateDynamicTexture(const FImGuiTextureHandle& Handle, const FIntRect& Rect, const uint8* Data, int32 SrcPitch);
+
+	/**
+	 * Request font glyphs for characters used in the given text. Glyphs missing in the default font are taken from the
+	 * glyph font set in ImGui settings and added to the font atlas in one of the next frames, so the atlas only contains
+	 * glyphs that are actually used. When the atlas is full, glyphs that were not drawn for the longest time are
+	 * replaced, so glyphs should be requested before they are drawn. Requesting glyphs that are already in the atlas is
+	 * cheap, so it is fine to do it every frame. Should be called from the game thread (e.g. from debug delegates).
+	 *
+	 * @param Text - Text with characters for which glyphs are requested
+	 */
+	virtual void RequestFontGlyphs(const FString& Text);
+
 	/**
 	 * Get ImGui module properties.
 	 *
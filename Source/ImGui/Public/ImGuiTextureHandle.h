@@ -29,7 +29,9 @@ public:
 
 	/**
 	 * Checks whether this handle is not null and valid. Valid handle points to valid texture resources.
-	 * It is slower but safer test, more useful when there is no guarantee that resources haven't been released.
+	 * It is a safer test, more useful when there is no guarantee that resources haven't been released. Handles to
+	 * released resources stay invalid when their texture ids are reused by other textures, until the generation
+	 * encoded in the id wraps around. After that, the handle is only valid if the texture with that id has the same name.
 	 *
 	 * @returns True, if this handle is not null and valid, false otherwise.
 	 */
@@ -53,7 +55,7 @@ private:
 	 */
 	FImGuiTextureHandle(const FName& InName, ImTextureID InTextureId);
 
-	/** Checks if texture manager has entry that matches this name and texture id index. */
+	/** Checks if texture manager has a valid entry with this name for this texture id (ids encode entry generations). */
 	bool HasValidEntry() const;
 
 	FName Name;